@@ -1,11 +1,39 @@
 
 #include "AllocationEngine.h"
 
-ParkingSlot* AllocationEngine::allocateSlot(int requestedZoneId, Zone* zones, int zoneCount)
+namespace
 {
-    if (zones == nullptr || zoneCount <= 0)
+    using Type = ParkingSlot::Type;
+
+    // Slot types a vehicle class may park in, best first.
+    struct Fallbacks
+    {
+        int count;
+        Type types[3];
+    };
+
+    // Indexed by vehicle class.
+    const Fallbacks COMPATIBLE[ParkingSlot::TYPE_COUNT] = {
+        /* STANDARD   */ { 2, { Type::STANDARD, Type::OVERSIZED } },
+        /* COMPACT    */ { 3, { Type::COMPACT, Type::STANDARD, Type::OVERSIZED } },
+        /* EV         */ { 1, { Type::EV } },
+        /* ACCESSIBLE */ { 1, { Type::ACCESSIBLE } },
+        /* MOTORCYCLE */ { 3, { Type::MOTORCYCLE, Type::COMPACT, Type::STANDARD } },
+        /* OVERSIZED  */ { 1, { Type::OVERSIZED } },
+    };
+}
+
+SlotRef AllocationEngine::allocateSlot(int requestedZoneId, Zone* zones, int zoneCount)
+{
+    return allocateRun(requestedZoneId, zones, zoneCount, 1);
+}
+
+SlotRef AllocationEngine::allocateRun(int requestedZoneId, Zone* zones, int zoneCount, int slotCount,
+                                      ParkingSlot::Type vehicleClass)
+{
+    if (zones == nullptr || zoneCount <= 0 || slotCount <= 0)
     {
-        return nullptr;
+        return SlotRef();
     }
 
     // 1. Try to allocate in the requested zone first
@@ -13,8 +41,8 @@ ParkingSlot* AllocationEngine::allocateSlot(int requestedZoneId, Zone* zones, in
     {
         if (zones[i].getZoneId() == requestedZoneId)
         {
-            ParkingSlot* slot = zones[i].findAvailableSlotInZone();
-            if (slot != nullptr)
+            SlotRef slot = findRunForClass(zones[i], vehicleClass, slotCount);
+            if (slot)
             {
                 return slot;
             }
@@ -30,14 +58,111 @@ ParkingSlot* AllocationEngine::allocateSlot(int requestedZoneId, Zone* zones, in
             continue;
         }
 
-        ParkingSlot* slot = zones[i].findAvailableSlotInZone();
-        if (slot != nullptr)
+        SlotRef slot = findRunForClass(zones[i], vehicleClass, slotCount);
+        if (slot)
         {
             return slot;
         }
     }
 
     // No available slots in any zone
-    return nullptr;
+    return SlotRef();
+}
+
+SlotRef AllocationEngine::findForClass(Zone& zone, ParkingSlot::Type vehicleClass, int powerWatts)
+{
+    const Fallbacks& fallbacks = COMPATIBLE[static_cast<int>(vehicleClass)];
+    for (int i = 0; i < fallbacks.count; ++i)
+    {
+        SlotRef slot = zone.findFreeSlotOfType(static_cast<int>(fallbacks.types[i]), powerWatts);
+        if (slot)
+        {
+            return slot;
+        }
+    }
+
+    return SlotRef();
+}
+
+SlotRef AllocationEngine::findRunForClass(Zone& zone, ParkingSlot::Type vehicleClass, int slotCount)
+{
+    const Fallbacks& fallbacks = COMPATIBLE[static_cast<int>(vehicleClass)];
+    for (int i = 0; i < fallbacks.count; ++i)
+    {
+        SlotRef slot = zone.findFreeRunInZone(slotCount, static_cast<int>(fallbacks.types[i]));
+        if (slot)
+        {
+            return slot;
+        }
+    }
+
+    return SlotRef();
+}
+
+bool AllocationEngine::isCompatible(ParkingSlot::Type vehicleClass, int slotType)
+{
+    const Fallbacks& fallbacks = COMPATIBLE[static_cast<int>(vehicleClass)];
+    for (int i = 0; i < fallbacks.count; ++i)
+    {
+        if (static_cast<int>(fallbacks.types[i]) == slotType)
+        {
+            return true;
+        }
+    }
+
+    return false;
 }
 
+int AllocationEngine::peekForClass(const Zone& zone, ParkingSlot::Type vehicleClass)
+{
+    const Fallbacks& fallbacks = COMPATIBLE[static_cast<int>(vehicleClass)];
+    for (int i = 0; i < fallbacks.count; ++i)
+    {
+        int slotId = zone.peekFreeSlotOfType(static_cast<int>(fallbacks.types[i]));
+        if (slotId >= 0)
+        {
+            return slotId;
+        }
+    }
+
+    return -1;
+}
+
+SlotRef AllocationEngine::allocateForClass(int requestedZoneId, Zone* zones, int zoneCount, ParkingSlot::Type vehicleClass,
+                                           int powerWatts)
+{
+    if (zones == nullptr || zoneCount <= 0)
+    {
+        return SlotRef();
+    }
+
+    // 1. Every compatible type in the requested zone
+    for (int i = 0; i < zoneCount; ++i)
+    {
+        if (zones[i].getZoneId() == requestedZoneId)
+        {
+            SlotRef slot = findForClass(zones[i], vehicleClass, powerWatts);
+            if (slot)
+            {
+                return slot;
+            }
+        }
+    }
+
+    // 2. Then the other zones
+    for (int i = 0; i < zoneCount; ++i)
+    {
+        if (zones[i].getZoneId() == requestedZoneId)
+        {
+            continue;
+        }
+
+        SlotRef slot = findForClass(zones[i], vehicleClass, powerWatts);
+        if (slot)
+        {
+            return slot;
+        }
+    }
+
+    return SlotRef();
+}
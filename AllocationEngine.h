@@ -8,7 +8,8 @@
 class AllocationEngine
 {
 public:
-    // Attempts to allocate a parking slot for the given requested zone.
+    // Attempts to allocate a parking slot for a standard car (see
+    // allocateForClass) in the given requested zone.
     // Preference:
     // 1. First available slot in the requested zone.
     // 2. If none, first available slot in any other zone (cross-zone allocation).
@@ -19,8 +20,39 @@ public:
     // - zoneCount: number of zones in the array.
     //
     // Returns:
-    // - Pointer to allocated ParkingSlot, or nullptr if none available.
-    ParkingSlot* allocateSlot(int requestedZoneId, Zone* zones, int zoneCount);
+    // - Handle to the allocated slot, or an empty handle if none available.
+    SlotRef allocateSlot(int requestedZoneId, Zone* zones, int zoneCount);
+
+    // Same preference order for slotCount adjacent slots in one area (e.g.
+    // a bus or a trailer), all of one type that vehicleClass may use. Types
+    // are tried in compatibility-table order within each zone, so an
+    // untyped (STANDARD) vehicle never spills into EV or ACCESSIBLE bays
+    // and a run never mixes types. Returns the first slot of the run; the
+    // caller claims all slotCount of them.
+    SlotRef allocateRun(int requestedZoneId, Zone* zones, int zoneCount, int slotCount,
+                        ParkingSlot::Type vehicleClass = ParkingSlot::Type::STANDARD);
+
+    // One slot for a vehicle of the given class. Within each zone (requested
+    // zone first, as above) the slot types the class may use are tried in
+    // the fixed order of the compatibility table, e.g. a compact car takes a
+    // COMPACT bay, else a STANDARD one, else an OVERSIZED one. Each try is
+    // an O(log n) free-slot tree lookup per area. With powerWatts > 0 only areas
+    // whose charging budget still has that much headroom are considered;
+    // the caller reserves it on the returned slot.
+    SlotRef allocateForClass(int requestedZoneId, Zone* zones, int zoneCount, ParkingSlot::Type vehicleClass,
+                             int powerWatts = 0);
+
+    // Whether a vehicle of this class may use a slot of this type.
+    static bool isCompatible(ParkingSlot::Type vehicleClass, int slotType);
+
+    // Id of a free slot in zone that a vehicle of this class may use, best
+    // type first, or -1. Read-only (see Zone::peekFreeSlotOfType), so it
+    // may run under a shared lock.
+    static int peekForClass(const Zone& zone, ParkingSlot::Type vehicleClass);
+
+private:
+    SlotRef findForClass(Zone& zone, ParkingSlot::Type vehicleClass, int powerWatts);
+    SlotRef findRunForClass(Zone& zone, ParkingSlot::Type vehicleClass, int slotCount);
 };
 
 #endif  // ALLOCATION_ENGINE_H
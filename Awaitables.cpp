@@ -0,0 +1,50 @@
+#include "Awaitables.h"
+
+#include "ParkingSystem.h"
+
+void spawnHandler(const crow::request& req, crow::response& res, asio::awaitable<crow::response> handler)
+{
+    // `res` stays valid until end(): the connection keeps itself alive
+    // while a response is outstanding.
+    asio::co_spawn(*req.io_context, std::move(handler),
+        [&res](std::exception_ptr error, crow::response result)
+        {
+            if (error)
+            {
+                result = crow::response(500);
+            }
+            res = std::move(result);
+            res.end();
+        });
+}
+
+asio::awaitable<bool> awaitFreeSlot(ParkingSystem& system, int zoneId, std::chrono::milliseconds timeout)
+{
+    auto executor = co_await asio::this_coro::executor;
+
+    // Shared with the wakeup, which may run after this coroutine has
+    // finished (timeout and wakeup racing).
+    auto timer = std::make_shared<asio::steady_timer>(executor, timeout);
+
+    // Runs on whichever thread freed the slot, under the waiter lock:
+    // only hop back onto this coroutine's executor.
+    std::uint64_t token = system.waitForSlot(zoneId, [executor, timer]()
+    {
+        asio::post(executor, [timer]() { timer->cancel(); });
+    });
+
+    if (token == 0)
+    {
+        co_return true;  // already a free slot
+    }
+
+    asio::error_code ec;
+    co_await timer->async_wait(asio::redirect_error(asio::use_awaitable, ec));
+    if (ec == asio::error::operation_aborted)
+    {
+        co_return true;  // woken
+    }
+
+    // Timed out, unless the wakeup is already on its way.
+    co_return !system.cancelWait(zoneId, token);
+}
@@ -0,0 +1,68 @@
+#ifndef AWAITABLES_H
+#define AWAITABLES_H
+
+#include <chrono>
+#include <memory>
+#include <utility>
+
+#include "server/Crow-master/include/crow.h"
+
+#include "CommandQueue.h"
+
+class ParkingSystem;
+
+// Coroutine support for HTTP handlers (C++20, asio::awaitable).
+//
+// A handler written as `asio::awaitable<crow::response> handler(...)` is
+// started with spawnHandler() on its connection's io_context. Each
+// co_await suspends the coroutine and frees the worker thread; the
+// coroutine later resumes on the same io_context. A request waiting on the
+// command queue or the availability waitlist therefore costs a coroutine
+// frame, not a thread, and a few Crow workers can carry tens of thousands
+// of in-flight requests.
+//
+// Coroutines on one worker interleave at co_await points. Never keep a
+// default-constructed (thread-local) JsonWriter alive across a co_await.
+
+// Runs `handler` and completes `res` with its result (500 if it throws).
+void spawnHandler(const crow::request& req, crow::response& res, asio::awaitable<crow::response> handler);
+
+struct CommandOutcome
+{
+    bool queued;  // false: the queue was full and nothing was applied
+    int result;   // see CommandQueue::Done
+};
+
+// Suspends until the command has been applied and published.
+// `submit(done)` forwards to one of CommandQueue's methods, e.g.
+//   awaitCommand([&](CommandQueue::Done done) { return queue.cancelRequest(id, std::move(done)); })
+template <typename Submit>
+asio::awaitable<CommandOutcome> awaitCommand(Submit submit)
+{
+    auto executor = co_await asio::this_coro::executor;
+
+    co_return co_await asio::async_initiate<decltype(asio::use_awaitable), void(CommandOutcome)>(
+        [executor, &submit](auto handler)
+        {
+            // CommandQueue::Done must be copyable and runs on the writer
+            // thread; resume the coroutine on its own executor instead.
+            auto shared = std::make_shared<decltype(handler)>(std::move(handler));
+            bool queued = submit([executor, shared](int result)
+            {
+                asio::post(executor, [shared, result]() { std::move(*shared)(CommandOutcome{ true, result }); });
+            });
+
+            if (!queued)
+            {
+                asio::post(executor, [shared]() { std::move(*shared)(CommandOutcome{ false, -1 }); });
+            }
+        },
+        asio::use_awaitable);
+}
+
+// Suspends until a slot in zoneId that a standard car may use is freed
+// (true) or the timeout passes (false). Returns true at once if the zone
+// already has one free.
+asio::awaitable<bool> awaitFreeSlot(ParkingSystem& system, int zoneId, std::chrono::milliseconds timeout);
+
+#endif  // AWAITABLES_H
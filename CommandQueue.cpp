@@ -0,0 +1,233 @@
+#include "CommandQueue.h"
+
+#include <ctime>
+#include <iostream>
+#include <utility>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "ParkingSystem.h"
+
+CommandQueue::CommandQueue(ParkingSystem& system, int cpu)
+    : system(system),
+      cpu(cpu),
+      ring(CAPACITY),
+      head(0),
+      count(0),
+      nextSequence(0),
+      running(false)
+{
+}
+
+CommandQueue::~CommandQueue()
+{
+    stop();
+}
+
+void CommandQueue::start()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running)
+    {
+        return;
+    }
+
+    running = true;
+    writer = std::thread(&CommandQueue::run, this);
+}
+
+void CommandQueue::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    ready.notify_all();
+
+    if (writer.joinable())
+    {
+        writer.join();
+    }
+}
+
+bool CommandQueue::push(Command&& command)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running || count == CAPACITY)
+        {
+            return false;
+        }
+
+        command.sequence = nextSequence++;
+        command.time = static_cast<long long>(std::time(nullptr));
+        ring[(head + count) % CAPACITY] = std::move(command);
+        ++count;
+    }
+    ready.notify_one();
+    return true;
+}
+
+bool CommandQueue::requestParking(std::string vehicleId, int requestedZoneId, Done done, int slotCount,
+                                  int vehicleClass, int chargeWatts)
+{
+    Command command;
+    command.kind = Command::REQUEST_PARKING;
+    command.vehicleId = std::move(vehicleId);
+    command.id = requestedZoneId;
+    command.slotCount = slotCount;
+    command.vehicleClass = vehicleClass;
+    command.chargeWatts = chargeWatts;
+    command.done = std::move(done);
+    return push(std::move(command));
+}
+
+bool CommandQueue::cancelRequest(int requestId, Done done)
+{
+    Command command;
+    command.kind = Command::CANCEL_REQUEST;
+    command.id = requestId;
+    command.done = std::move(done);
+    return push(std::move(command));
+}
+
+bool CommandQueue::releaseSlot(int requestId, Done done)
+{
+    Command command;
+    command.kind = Command::RELEASE_SLOT;
+    command.id = requestId;
+    command.done = std::move(done);
+    return push(std::move(command));
+}
+
+bool CommandQueue::occupySlot(int requestId, Done done)
+{
+    Command command;
+    command.kind = Command::OCCUPY_SLOT;
+    command.id = requestId;
+    command.done = std::move(done);
+    return push(std::move(command));
+}
+
+bool CommandQueue::addZone(Zone zone, Done done)
+{
+    Command command;
+    command.kind = Command::ADD_ZONE;
+    command.id = zone.getZoneId();
+    command.zone = std::move(zone);
+    command.done = std::move(done);
+    return push(std::move(command));
+}
+
+bool CommandQueue::applySlotReadings(std::vector<SlotReading>& readings, Done done)
+{
+    Command command;
+    command.kind = Command::SLOT_READINGS;
+    command.readings = std::move(readings);
+    command.done = std::move(done);
+    if (push(std::move(command)))
+    {
+        return true;
+    }
+
+    readings = std::move(command.readings);
+    return false;
+}
+
+int CommandQueue::apply(Command& command)
+{
+    switch (command.kind)
+    {
+    case Command::REQUEST_PARKING:
+        return system.requestParking(command.vehicleId, command.id, command.slotCount, command.vehicleClass,
+                                     command.chargeWatts, command.time);
+    case Command::CANCEL_REQUEST:
+        return system.cancelRequest(command.id, command.time) ? 1 : 0;
+    case Command::RELEASE_SLOT:
+        return system.releaseSlot(command.id, command.time) ? 1 : 0;
+    case Command::OCCUPY_SLOT:
+        return system.occupySlot(command.id, command.time) ? 1 : 0;
+    case Command::ADD_ZONE:
+        return system.emplaceZone(std::move(*command.zone), command.time) ? 1 : 0;
+    case Command::SLOT_READINGS:
+    {
+        int moved = 0;
+        for (const auto& reading : command.readings)
+        {
+            if (system.applySensorReading(reading.zoneId, reading.slotId, reading.occupied, command.time) >= 0)
+            {
+                ++moved;
+            }
+        }
+        return moved;
+    }
+    }
+    return -1;
+}
+
+void CommandQueue::run()
+{
+#ifdef __linux__
+    if (cpu >= 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#endif
+
+    std::vector<Command> batch;
+    std::vector<int> results;
+    batch.reserve(MAX_BATCH);
+    results.reserve(MAX_BATCH);
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ready.wait(lock, [this]() { return count > 0 || !running; });
+            if (count == 0)
+            {
+                return;  // stopped and drained
+            }
+
+            while (count > 0 && batch.size() < MAX_BATCH)
+            {
+                batch.push_back(std::move(ring[head]));
+                head = (head + 1) % CAPACITY;
+                --count;
+            }
+        }
+
+        system.beginBatch();
+        for (auto& command : batch)
+        {
+            int result = -1;
+            try
+            {
+                result = apply(command);
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << "CommandQueue: command " << command.sequence << " failed: " << e.what() << std::endl;
+            }
+            results.push_back(result);
+        }
+        system.endBatch();
+
+        for (std::size_t i = 0; i < batch.size(); ++i)
+        {
+            if (batch[i].done)
+            {
+                batch[i].done(results[i]);
+            }
+        }
+
+        batch.clear();
+        results.clear();
+    }
+}
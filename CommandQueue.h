@@ -0,0 +1,125 @@
+#ifndef COMMAND_QUEUE_H
+#define COMMAND_QUEUE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Zone.h"
+
+class ParkingSystem;
+
+// Single-writer front end for ParkingSystem mutations.
+//
+// Any thread may submit commands to a bounded multi-producer queue. One
+// writer thread (optionally pinned to a CPU) drains the queue in batches of
+// up to MAX_BATCH and applies each batch inside ParkingSystem::beginBatch()
+// / endBatch(), so a burst of N mutations costs one lock acquisition, one
+// publish and one copy of the top-level snapshot rather than N. Within the
+// batch each touched zone, and each touched CowVector leaf of holders or
+// requests, is copied once and then patched in place. Commands are applied
+// strictly in submission order (see Command::sequence) with the time they
+// were submitted (Command::time), so a log of commands is enough to replay
+// the exact same decisions.
+//
+// Completion callbacks run on the writer thread after the batch has been
+// published, so anything they read from the snapshot already reflects the
+// command. They must be quick: hand the result off (e.g. post to an
+// io_context) rather than doing I/O.
+class CommandQueue
+{
+public:
+    static const std::size_t CAPACITY = 4096;
+    static const std::size_t MAX_BATCH = 128;
+
+    // Receives the command's result:
+    //   requestParking -> request id, or -1 if no slot
+    //   cancelRequest / releaseSlot / occupySlot -> 1 on success, 0 otherwise
+    //   addZone -> 1 on success, 0 if the zone id is taken
+    //   applySlotReadings -> number of requests the readings moved
+    using Done = std::function<void(int result)>;
+
+    // A sensor-reported change of one slot (see SensorListener).
+    struct SlotReading
+    {
+        int zoneId;
+        int slotId;
+        bool occupied;
+    };
+
+    struct Command
+    {
+        enum Kind
+        {
+            REQUEST_PARKING,
+            CANCEL_REQUEST,
+            RELEASE_SLOT,
+            OCCUPY_SLOT,
+            ADD_ZONE,
+            SLOT_READINGS
+        };
+
+        Kind kind = REQUEST_PARKING;
+        std::uint64_t sequence = 0;
+        long long time = 0;        // seconds since epoch, stamped by push()
+        std::string vehicleId;     // REQUEST_PARKING
+        int id = -1;               // requested zone, or request id
+        int slotCount = 1;         // REQUEST_PARKING
+        int vehicleClass = -1;     // REQUEST_PARKING; -1 is a standard car
+        int chargeWatts = 0;       // REQUEST_PARKING
+        std::optional<Zone> zone;  // ADD_ZONE
+        std::vector<SlotReading> readings;  // SLOT_READINGS
+        Done done;
+    };
+
+private:
+    ParkingSystem& system;
+    int cpu;
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::vector<Command> ring;  // CAPACITY slots
+    std::size_t head;
+    std::size_t count;
+    std::uint64_t nextSequence;
+    bool running;
+    std::thread writer;
+
+    // Leaves `command` untouched when the queue is full.
+    bool push(Command&& command);
+    void run();
+    int apply(Command& command);
+
+public:
+    // cpu: core to pin the writer thread to, or -1 to leave it floating.
+    CommandQueue(ParkingSystem& system, int cpu);
+    ~CommandQueue();
+
+    CommandQueue(const CommandQueue&) = delete;
+    CommandQueue& operator=(const CommandQueue&) = delete;
+
+    void start();
+
+    // Applies everything already queued, then joins the writer thread.
+    void stop();
+
+    // Each returns false without queuing when the queue is full (callers
+    // should shed load, e.g. 503), otherwise `done` is called exactly once.
+    bool requestParking(std::string vehicleId, int requestedZoneId, Done done, int slotCount = 1,
+                        int vehicleClass = -1, int chargeWatts = 0);
+    bool cancelRequest(int requestId, Done done);
+    bool releaseSlot(int requestId, Done done);
+    bool occupySlot(int requestId, Done done);
+    bool addZone(Zone zone, Done done);
+
+    // Applies readings in order as one command (one queue slot, one batch).
+    // `readings` is moved from only when queued; `done` may be empty.
+    bool applySlotReadings(std::vector<SlotReading>& readings, Done done);
+};
+
+#endif  // COMMAND_QUEUE_H
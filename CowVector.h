@@ -0,0 +1,122 @@
+#ifndef COW_VECTOR_H
+#define COW_VECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Copy-on-write array for snapshot state. Elements sit in leaves of
+// LEAF_SIZE, leaves in pages of PAGE_SIZE, both behind shared pointers, so
+// copying the vector copies only its page pointers (one per 64K elements)
+// and writing one element copies only its leaf and page.
+//
+// Every leaf and page carries the epoch of the update that made it. A
+// write under the same epoch patches it in place, so one update touching
+// an element twice (or two neighbours) copies once. The caller must use a
+// fresh epoch for each unpublished copy: anything tagged with an epoch is
+// assumed to be reachable only from that copy.
+template <typename T>
+class CowVector
+{
+private:
+    struct Leaf
+    {
+        std::uint64_t epoch;
+        std::vector<T> items;
+    };
+
+    struct Page
+    {
+        std::uint64_t epoch;
+        std::vector<std::shared_ptr<Leaf>> leaves;
+    };
+
+    std::vector<std::shared_ptr<Page>> pages;
+    std::size_t count;
+
+    Page& ownPage(std::size_t page, std::uint64_t epoch)
+    {
+        if (pages[page]->epoch != epoch)
+        {
+            pages[page] = std::make_shared<Page>(*pages[page]);
+            pages[page]->epoch = epoch;
+        }
+        return *pages[page];
+    }
+
+    Leaf& ownLeaf(Page& page, std::size_t leaf, std::uint64_t epoch)
+    {
+        if (page.leaves[leaf]->epoch != epoch)
+        {
+            page.leaves[leaf] = std::make_shared<Leaf>(*page.leaves[leaf]);
+            page.leaves[leaf]->epoch = epoch;
+        }
+        return *page.leaves[leaf];
+    }
+
+    const Leaf& leafAt(std::size_t index) const
+    {
+        std::size_t leaf = index / LEAF_SIZE;
+        return *pages[leaf / PAGE_SIZE]->leaves[leaf % PAGE_SIZE];
+    }
+
+public:
+    static const std::size_t LEAF_SIZE = 256;
+    static const std::size_t PAGE_SIZE = 256;
+
+    CowVector()
+        : count(0)
+    {
+    }
+
+    std::size_t size() const
+    {
+        return count;
+    }
+
+    const T& operator[](std::size_t index) const
+    {
+        return leafAt(index).items[index % LEAF_SIZE];
+    }
+
+    // Mutable element, copying its leaf and page first unless they already
+    // belong to this epoch.
+    T& write(std::size_t index, std::uint64_t epoch)
+    {
+        std::size_t leaf = index / LEAF_SIZE;
+        Page& page = ownPage(leaf / PAGE_SIZE, epoch);
+        return ownLeaf(page, leaf % PAGE_SIZE, epoch).items[index % LEAF_SIZE];
+    }
+
+    void push_back(const T& value, std::uint64_t epoch)
+    {
+        std::size_t leaf = count / LEAF_SIZE;
+        if (count % LEAF_SIZE == 0)
+        {
+            if (leaf % PAGE_SIZE == 0)
+            {
+                pages.push_back(std::make_shared<Page>());
+                pages.back()->epoch = epoch;
+            }
+
+            auto fresh = std::make_shared<Leaf>();
+            fresh->epoch = epoch;
+            fresh->items.reserve(LEAF_SIZE);
+            ownPage(leaf / PAGE_SIZE, epoch).leaves.push_back(std::move(fresh));
+        }
+
+        Page& page = ownPage(leaf / PAGE_SIZE, epoch);
+        ownLeaf(page, leaf % PAGE_SIZE, epoch).items.push_back(value);
+        count += 1;
+    }
+
+    // True if index's leaf is the same block in both, i.e. that leaf is
+    // unchanged between the two copies.
+    bool sharesLeaf(const CowVector& other, std::size_t index) const
+    {
+        return index < count && index < other.count && &leafAt(index) == &other.leafAt(index);
+    }
+};
+
+#endif  // COW_VECTOR_H
@@ -0,0 +1,143 @@
+#include "FacilityTree.h"
+
+#include <utility>
+
+int FacilityTree::addNode(int parentId, const std::string& kind, const std::string& name)
+{
+    if (parentId != -1 && (!contains(parentId) || nodes[parentId].zoneId >= 0))
+    {
+        return -1;
+    }
+
+    Node node;
+    node.parentId = parentId;
+    node.zoneId = -1;
+    node.kind = kind;
+    node.name = name;
+    node.freeSlots = 0;
+    node.totalSlots = 0;
+    node.freeStandard = 0;
+    node.freeIndex = -1;
+
+    int id = static_cast<int>(nodes.size());
+    nodes.push_back(std::move(node));
+    if (parentId != -1)
+    {
+        nodes[parentId].children.push_back(id);
+    }
+    return id;
+}
+
+int FacilityTree::attachZone(int parentId, int zoneId, const std::string& name, int freeSlots, int totalSlots,
+                             int freeStandard)
+{
+    if (zoneNodes.count(zoneId) != 0)
+    {
+        return -1;
+    }
+
+    int id = addNode(parentId, "zone", name);
+    if (id < 0)
+    {
+        return -1;
+    }
+
+    nodes[id].zoneId = zoneId;
+    zoneNodes[zoneId] = id;
+
+    // Starts empty; the counts flow up like any other change.
+    onZoneChange(zoneId, freeSlots, totalSlots, freeStandard);
+    return id;
+}
+
+void FacilityTree::onZoneChange(int zoneId, int freeDelta, int totalDelta, int freeStandardDelta)
+{
+    auto found = zoneNodes.find(zoneId);
+    if (found == zoneNodes.end())
+    {
+        return;
+    }
+
+    for (int id = found->second; id != -1; id = nodes[id].parentId)
+    {
+        Node& node = nodes[id];
+        bool hadFree = node.freeStandard > 0;
+        node.freeSlots += freeDelta;
+        node.totalSlots += totalDelta;
+        node.freeStandard += freeStandardDelta;
+
+        bool hasFree = node.freeStandard > 0;
+        if (hadFree != hasFree)
+        {
+            setHasFree(id, hasFree);
+        }
+    }
+}
+
+void FacilityTree::setHasFree(int childId, bool hasFree)
+{
+    Node& child = nodes[childId];
+    if (child.parentId == -1)
+    {
+        return;
+    }
+
+    std::vector<int>& list = nodes[child.parentId].freeChildren;
+    if (hasFree)
+    {
+        child.freeIndex = static_cast<int>(list.size());
+        list.push_back(childId);
+        return;
+    }
+
+    int moved = list.back();
+    list[child.freeIndex] = moved;
+    nodes[moved].freeIndex = child.freeIndex;
+    list.pop_back();
+    child.freeIndex = -1;
+}
+
+bool FacilityTree::contains(int nodeId) const
+{
+    return nodeId >= 0 && nodeId < static_cast<int>(nodes.size());
+}
+
+FacilityTree::Summary FacilityTree::summarize(int nodeId) const
+{
+    const Node& node = nodes[nodeId];
+
+    Summary summary;
+    summary.id = nodeId;
+    summary.parentId = node.parentId;
+    summary.zoneId = node.zoneId;
+    summary.kind = node.kind;
+    summary.name = node.name;
+    summary.freeSlots = node.freeSlots;
+    summary.totalSlots = node.totalSlots;
+    return summary;
+}
+
+const std::vector<int>& FacilityTree::getChildren(int nodeId) const
+{
+    return nodes[nodeId].children;
+}
+
+int FacilityTree::findFreeZone(int nodeId) const
+{
+    if (!contains(nodeId))
+    {
+        return -1;
+    }
+
+    const Node* node = &nodes[nodeId];
+    while (node->zoneId < 0)
+    {
+        if (node->freeChildren.empty())
+        {
+            return -1;
+        }
+        node = &nodes[node->freeChildren.back()];
+    }
+
+    return node->freeStandard > 0 ? node->zoneId : -1;
+}
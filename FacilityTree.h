@@ -0,0 +1,82 @@
+#ifndef FACILITY_TREE_H
+#define FACILITY_TREE_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Site hierarchy above the zones (campus -> building -> level -> ...),
+// with zones attached as leaves. Every node keeps the free / total slot
+// counts of everything below it, so:
+//   - a slot changing state in a zone updates one node per level, and
+//   - "free slots under node N" is a field read, and
+//   - "some zone under node N with a free standard slot" walks down one
+//     path,
+// all O(depth) instead of scanning slots.
+//
+// To make that last walk O(depth) each node also counts the free slots a
+// standard car may use (STANDARD-class, so not EV or ACCESSIBLE bays) and
+// keeps the list of its children that currently have one (swap-removed in
+// O(1)).
+//
+// Not synchronized; ParkingSystem guards it with stateLock.
+class FacilityTree
+{
+public:
+    struct Summary
+    {
+        int id;
+        int parentId;   // -1 for a root
+        int zoneId;     // -1 unless this node is an attached zone
+        std::string kind;
+        std::string name;
+        int freeSlots;
+        int totalSlots;
+    };
+
+private:
+    struct Node
+    {
+        int parentId;
+        int zoneId;
+        std::string kind;
+        std::string name;
+        int freeSlots;
+        int totalSlots;
+        int freeStandard;
+        std::vector<int> children;
+
+        std::vector<int> freeChildren;  // children with freeStandard > 0
+        int freeIndex;  // position in the parent's freeChildren, or -1
+    };
+
+    std::vector<Node> nodes;  // id = index
+    std::unordered_map<int, int> zoneNodes;  // zoneId -> node id
+
+    void setHasFree(int childId, bool hasFree);
+
+public:
+    // Returns the new node's id, or -1 if parentId is neither -1 (new root)
+    // nor an existing non-zone node.
+    int addNode(int parentId, const std::string& kind, const std::string& name);
+
+    // Adds zoneId as a leaf under parentId with its current counts.
+    // Returns the leaf's id, or -1 if the parent is invalid or the zone is
+    // already attached somewhere.
+    int attachZone(int parentId, int zoneId, const std::string& name, int freeSlots, int totalSlots,
+                   int freeStandard);
+
+    // Applies a change in one zone to its leaf and every ancestor. Zones
+    // that are not attached are ignored.
+    void onZoneChange(int zoneId, int freeDelta, int totalDelta, int freeStandardDelta);
+
+    bool contains(int nodeId) const;
+    Summary summarize(int nodeId) const;
+    const std::vector<int>& getChildren(int nodeId) const;
+
+    // A zone under nodeId (or nodeId itself) with at least one free slot a
+    // standard car may use, or -1 if there is none below.
+    int findFreeZone(int nodeId) const;
+};
+
+#endif  // FACILITY_TREE_H
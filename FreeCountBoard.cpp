@@ -0,0 +1,63 @@
+#include "FreeCountBoard.h"
+
+FreeCountBoard::FreeCountBoard(std::chrono::milliseconds minInterval)
+    : minInterval(minInterval), lastEventId(0)
+{
+}
+
+void FreeCountBoard::update(const ParkingSnapshot& snapshot, Clock::time_point now, std::vector<Event>& out)
+{
+    for (std::size_t i = 0; i < snapshot.zones.size(); ++i)
+    {
+        const auto& view = snapshot.zones[i];
+
+        if (i >= zones.size())
+        {
+            // First sighting: publish immediately.
+            ZoneState state;
+            state.zoneId = view->zoneId;
+            state.seen = view;
+            state.freeSlots = view->capacity - view->occupiedSlots;
+            state.pending = false;
+            state.lastEmit = now;
+            state.latest = Event{ ++lastEventId, state.zoneId, state.freeSlots };
+            zones.push_back(state);
+            out.push_back(zones.back().latest);
+            continue;
+        }
+
+        ZoneState& state = zones[i];
+        if (state.seen != view)
+        {
+            state.seen = view;
+            state.freeSlots = view->capacity - view->occupiedSlots;
+            state.pending = state.freeSlots != state.latest.freeSlots;
+        }
+
+        if (!state.pending || now - state.lastEmit < minInterval)
+        {
+            continue;
+        }
+
+        state.pending = false;
+        state.lastEmit = now;
+        state.latest = Event{ ++lastEventId, state.zoneId, state.freeSlots };
+        out.push_back(state.latest);
+    }
+}
+
+void FreeCountBoard::missedSince(std::uint64_t lastSeenId, std::vector<Event>& out) const
+{
+    if (lastSeenId > lastEventId)
+    {
+        lastSeenId = 0;
+    }
+
+    for (const auto& state : zones)
+    {
+        if (state.latest.id > lastSeenId)
+        {
+            out.push_back(state.latest);
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef FREE_COUNT_BOARD_H
+#define FREE_COUNT_BOARD_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "ParkingSnapshot.h"
+
+// Turns published snapshots into per-zone "free slots" events for display
+// boards. This class only decides what to send; it does no I/O.
+//
+// - An event is emitted only when a zone's free count actually changes.
+// - Per zone, at most one event per minInterval. A change that arrives
+//   early is held back and emitted (latest value only) once the interval
+//   has passed.
+// - Event ids increase across all zones, and the latest event of each zone
+//   is kept. A client reconnecting with Last-Event-ID N therefore gets only
+//   the current value of zones that changed after N, never a replay.
+class FreeCountBoard
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Event
+    {
+        std::uint64_t id;
+        int zoneId;
+        int freeSlots;
+    };
+
+private:
+    struct ZoneState
+    {
+        int zoneId;
+        std::shared_ptr<const ZoneSnapshot> seen;  // last snapshot looked at
+        int freeSlots;                              // latest value
+        bool pending;                               // changed, held by rate limit
+        Clock::time_point lastEmit;
+        Event latest;                               // last event emitted
+    };
+
+    std::chrono::milliseconds minInterval;
+    std::uint64_t lastEventId;
+    std::vector<ZoneState> zones;  // same order as ParkingSnapshot::zones
+
+public:
+    explicit FreeCountBoard(std::chrono::milliseconds minInterval);
+
+    // Folds in the current snapshot and appends the events due at `now`.
+    // O(zones) pointer compares when nothing changed.
+    void update(const ParkingSnapshot& snapshot, Clock::time_point now, std::vector<Event>& out);
+
+    // Latest event of every zone that changed after lastSeenId. If the id
+    // is from the future (e.g. the server restarted), every zone is sent.
+    void missedSince(std::uint64_t lastSeenId, std::vector<Event>& out) const;
+};
+
+#endif  // FREE_COUNT_BOARD_H
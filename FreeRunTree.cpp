@@ -0,0 +1,150 @@
+#include "FreeRunTree.h"
+
+#include <algorithm>
+#include <bit>
+
+FreeRunTree::FreeRunTree()
+    : slotCount(0), leafCount(0)
+{
+}
+
+FreeRunTree::Runs FreeRunTree::blockRuns(std::uint64_t bits)
+{
+    if (bits == ~std::uint64_t(0))
+    {
+        return Runs{ BLOCK_BITS, BLOCK_BITS, BLOCK_BITS };
+    }
+
+    Runs runs;
+    runs.prefix = std::countr_one(bits);
+    runs.suffix = std::countl_one(bits);
+    runs.best = std::max(runs.prefix, runs.suffix);
+
+    // Walk the remaining runs of ones; at most 32 of them.
+    std::uint64_t rest = bits >> runs.prefix;
+    while (rest != 0)
+    {
+        rest >>= std::countr_zero(rest);
+        int run = std::countr_one(rest);
+        runs.best = std::max(runs.best, run);
+        rest >>= run;
+    }
+    return runs;
+}
+
+FreeRunTree::Runs FreeRunTree::combine(const Runs& left, const Runs& right, int leftLength, int rightLength)
+{
+    Runs runs;
+    runs.prefix = left.prefix == leftLength ? leftLength + right.prefix : left.prefix;
+    runs.suffix = right.suffix == rightLength ? rightLength + left.suffix : right.suffix;
+    runs.best = std::max({ left.best, right.best, left.suffix + right.prefix });
+    return runs;
+}
+
+void FreeRunTree::reset(int count)
+{
+    slotCount = count;
+    int blockCount = (count + BLOCK_BITS - 1) / BLOCK_BITS;
+    leafCount = 1;
+    while (leafCount < blockCount)
+    {
+        leafCount *= 2;
+    }
+
+    // Padding blocks and the bits past slotCount stay 0, i.e. never free.
+    blocks.assign(static_cast<std::size_t>(leafCount), 0);
+    nodes.assign(static_cast<std::size_t>(leafCount) * 2, Runs{ 0, 0, 0 });
+}
+
+void FreeRunTree::rebuildNodes()
+{
+    for (int block = 0; block < leafCount; ++block)
+    {
+        nodes[leafCount + block] = blockRuns(blocks[block]);
+    }
+
+    for (int first = leafCount / 2, childLength = BLOCK_BITS; first >= 1; first /= 2, childLength *= 2)
+    {
+        for (int node = first; node < first * 2; ++node)
+        {
+            nodes[node] = combine(nodes[node * 2], nodes[node * 2 + 1], childLength, childLength);
+        }
+    }
+}
+
+void FreeRunTree::refreshLeaf(int block)
+{
+    int node = leafCount + block;
+    nodes[node] = blockRuns(blocks[block]);
+
+    for (int childLength = BLOCK_BITS; node > 1; childLength *= 2)
+    {
+        node /= 2;
+        nodes[node] = combine(nodes[node * 2], nodes[node * 2 + 1], childLength, childLength);
+    }
+}
+
+void FreeRunTree::set(int index, bool free)
+{
+    std::uint64_t& bits = blocks[index / BLOCK_BITS];
+    std::uint64_t mask = std::uint64_t(1) << (index % BLOCK_BITS);
+    std::uint64_t updated = free ? (bits | mask) : (bits & ~mask);
+    if (updated == bits)
+    {
+        return;
+    }
+
+    bits = updated;
+    refreshLeaf(index / BLOCK_BITS);
+}
+
+int FreeRunTree::findRun(int count) const
+{
+    if (count <= 0 || nodes.empty() || nodes[1].best < count)
+    {
+        return -1;
+    }
+
+    int node = 1;
+    int offset = 0;
+    int length = leafCount * BLOCK_BITS;
+    while (node < leafCount)
+    {
+        int half = length / 2;
+        const Runs& left = nodes[node * 2];
+        const Runs& right = nodes[node * 2 + 1];
+
+        if (left.best >= count)
+        {
+            node = node * 2;
+        }
+        else if (left.suffix + right.prefix >= count)
+        {
+            // The leftmost run straddles the middle.
+            return offset + half - left.suffix;
+        }
+        else
+        {
+            node = node * 2 + 1;
+            offset += half;
+        }
+        length = half;
+    }
+
+    // Inside one block: bit i of starts is set when bits i .. i+count-1 are
+    // all free. Built by doubling, so log2(count) steps.
+    std::uint64_t bits = blocks[node - leafCount];
+    std::uint64_t starts = bits;
+    for (int covered = 1; covered < count;)
+    {
+        int shift = std::min(covered, count - covered);
+        starts &= starts >> shift;
+        covered += shift;
+    }
+    return offset + std::countr_zero(starts);
+}
+
+int FreeRunTree::size() const
+{
+    return slotCount;
+}
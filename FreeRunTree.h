@@ -0,0 +1,65 @@
+#ifndef FREE_RUN_TREE_H
+#define FREE_RUN_TREE_H
+
+#include <cstdint>
+#include <vector>
+
+// Index of the free slots of one area, for finding k adjacent free slots.
+//
+// Leaves are 64-slot bitmaps (bit i = slot i, 1 = free). Above them sits a
+// segment tree where each node stores, for its range, the longest free run
+// touching its left edge, its right edge, and anywhere inside. Two children
+// combine in O(1), so:
+//   findRun(k)        leftmost start of >= k adjacent free slots, O(log n)
+//   set(i, free)      one bit + one leaf-to-root path, O(log n)
+// Memory is one bit per slot plus 12 bytes per 64 slots (x2 for the tree).
+class FreeRunTree
+{
+private:
+    struct Runs
+    {
+        std::int32_t prefix;
+        std::int32_t suffix;
+        std::int32_t best;
+    };
+
+    int slotCount;
+    int leafCount;  // power of two >= number of 64-slot blocks
+    std::vector<std::uint64_t> blocks;
+    std::vector<Runs> nodes;  // 1-based heap; leaves at [leafCount, 2 * leafCount)
+
+    static Runs blockRuns(std::uint64_t bits);
+    static Runs combine(const Runs& left, const Runs& right, int leftLength, int rightLength);
+    void reset(int count);
+    void rebuildNodes();
+    void refreshLeaf(int block);
+
+public:
+    static const int BLOCK_BITS = 64;
+
+    FreeRunTree();
+
+    // Rebuilds from scratch in O(n); free[i] says whether slot i is free.
+    template <typename IsFree>
+    void build(int count, IsFree free)
+    {
+        reset(count);
+        for (int i = 0; i < count; ++i)
+        {
+            if (free(i))
+            {
+                blocks[i / BLOCK_BITS] |= std::uint64_t(1) << (i % BLOCK_BITS);
+            }
+        }
+        rebuildNodes();
+    }
+
+    void set(int index, bool free);
+
+    // Leftmost index starting a run of at least count free slots, or -1.
+    int findRun(int count) const;
+
+    int size() const;
+};
+
+#endif  // FREE_RUN_TREE_H
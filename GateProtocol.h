@@ -0,0 +1,165 @@
+#ifndef GATE_PROTOCOL_H
+#define GATE_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+// Fixed-layout binary framing spoken by gate controllers on GateServer's
+// port. All integers are little-endian. Every frame in a direction has the
+// same size, so a reader never has to parse a length before it knows where
+// the next frame starts, and a client may pipeline as many requests as it
+// likes without waiting for replies.
+//
+// Request frame (REQUEST_BYTES = 32):
+//    0  u8    op               Op below
+//    1  u8    vehicleIdLength  REQUEST only, <= MAX_VEHICLE_ID
+//    2  u16   reserved         must be 0
+//    4  u32   tag              chosen by the client, echoed in the reply
+//    8  i32   arg              REQUEST: requested zone id, else request id
+//   12  char  vehicleId[20]    REQUEST only; bytes past the length are 0
+//
+// Reply frame (REPLY_BYTES = 20):
+//    0  u8    op               echoed
+//    1  u8    status           Status below
+//    2  u8    state            ParkingRequest::State: the one the op produced, or
+//                              the current one if REJECTED (0xFF if unknown)
+//    3  u8    reserved
+//    4  u32   tag              echoed
+//    8  i32   requestId        -1 if none
+//   12  i32   zoneId           allocated zone, -1 if none
+//   16  i32   slotId           allocated slot, -1 if none
+//
+// Replies to one connection may arrive in a different order than the
+// requests (a rejected frame is answered at once, queued ones when they
+// have been applied); match them by tag.
+//
+// Header-only so that gate clients (and bench/gate_latency.cpp) can share it.
+class GateProtocol
+{
+public:
+    static const std::size_t REQUEST_BYTES = 32;
+    static const std::size_t REPLY_BYTES = 20;
+    static const std::size_t MAX_VEHICLE_ID = 20;
+    static const std::uint8_t UNKNOWN_STATE = 0xFF;
+
+    enum Op : std::uint8_t
+    {
+        REQUEST = 1,  // create a request and allocate a slot
+        OCCUPY = 2,   // vehicle entered: ALLOCATED -> OCCUPIED
+        RELEASE = 3,  // vehicle left: OCCUPIED -> RELEASED
+        CANCEL = 4    // give up a REQUESTED / ALLOCATED request
+    };
+
+    enum Status : std::uint8_t
+    {
+        OK = 0,
+        REJECTED = 1,   // no free slot, or the request is in the wrong state
+        NOT_FOUND = 2,  // unknown request id
+        BUSY = 3,       // server overloaded; retry later
+        BAD_FRAME = 4   // unknown op, non-zero reserved bits or bad length
+    };
+
+    struct Request
+    {
+        std::uint8_t op = 0;
+        std::uint32_t tag = 0;
+        std::int32_t arg = -1;
+        std::string_view vehicleId;  // points into the frame it was decoded from
+        bool valid = false;
+    };
+
+    struct Reply
+    {
+        std::uint8_t op = 0;
+        std::uint8_t status = OK;
+        std::uint8_t state = UNKNOWN_STATE;
+        std::uint32_t tag = 0;
+        std::int32_t requestId = -1;
+        std::int32_t zoneId = -1;
+        std::int32_t slotId = -1;
+    };
+
+    // Reads REQUEST_BYTES from frame. Structurally invalid frames come back
+    // with valid == false (op and tag are still filled in for the reply).
+    static Request decodeRequest(const unsigned char* frame)
+    {
+        Request request;
+        request.op = frame[0];
+        request.tag = readU32(frame + 4);
+        request.arg = static_cast<std::int32_t>(readU32(frame + 8));
+
+        std::size_t length = frame[1];
+        bool reservedClear = frame[2] == 0 && frame[3] == 0;
+        bool knownOp = request.op >= REQUEST && request.op <= CANCEL;
+        bool lengthOk = request.op == REQUEST ? length > 0 && length <= MAX_VEHICLE_ID : length == 0;
+
+        request.valid = reservedClear && knownOp && lengthOk;
+        if (request.valid && request.op == REQUEST)
+        {
+            request.vehicleId = std::string_view(reinterpret_cast<const char*>(frame + 12), length);
+        }
+        return request;
+    }
+
+    // Appends one REQUEST_BYTES frame. vehicleId is truncated to MAX_VEHICLE_ID.
+    static void appendRequest(std::string& out, Op op, std::uint32_t tag, std::int32_t arg,
+                              std::string_view vehicleId = std::string_view())
+    {
+        unsigned char frame[REQUEST_BYTES] = {};
+        std::size_t length = vehicleId.size() < MAX_VEHICLE_ID ? vehicleId.size() : MAX_VEHICLE_ID;
+        frame[0] = op;
+        frame[1] = static_cast<std::uint8_t>(length);
+        writeU32(frame + 4, tag);
+        writeU32(frame + 8, static_cast<std::uint32_t>(arg));
+        std::memcpy(frame + 12, vehicleId.data(), length);
+        out.append(reinterpret_cast<const char*>(frame), REQUEST_BYTES);
+    }
+
+    static Reply decodeReply(const unsigned char* frame)
+    {
+        Reply reply;
+        reply.op = frame[0];
+        reply.status = frame[1];
+        reply.state = frame[2];
+        reply.tag = readU32(frame + 4);
+        reply.requestId = static_cast<std::int32_t>(readU32(frame + 8));
+        reply.zoneId = static_cast<std::int32_t>(readU32(frame + 12));
+        reply.slotId = static_cast<std::int32_t>(readU32(frame + 16));
+        return reply;
+    }
+
+    static void appendReply(std::string& out, const Reply& reply)
+    {
+        unsigned char frame[REPLY_BYTES] = {};
+        frame[0] = reply.op;
+        frame[1] = reply.status;
+        frame[2] = reply.state;
+        writeU32(frame + 4, reply.tag);
+        writeU32(frame + 8, static_cast<std::uint32_t>(reply.requestId));
+        writeU32(frame + 12, static_cast<std::uint32_t>(reply.zoneId));
+        writeU32(frame + 16, static_cast<std::uint32_t>(reply.slotId));
+        out.append(reinterpret_cast<const char*>(frame), REPLY_BYTES);
+    }
+
+private:
+    static std::uint32_t readU32(const unsigned char* p)
+    {
+        return static_cast<std::uint32_t>(p[0]) |
+               static_cast<std::uint32_t>(p[1]) << 8 |
+               static_cast<std::uint32_t>(p[2]) << 16 |
+               static_cast<std::uint32_t>(p[3]) << 24;
+    }
+
+    static void writeU32(unsigned char* p, std::uint32_t v)
+    {
+        p[0] = static_cast<unsigned char>(v);
+        p[1] = static_cast<unsigned char>(v >> 8);
+        p[2] = static_cast<unsigned char>(v >> 16);
+        p[3] = static_cast<unsigned char>(v >> 24);
+    }
+};
+
+#endif  // GATE_PROTOCOL_H
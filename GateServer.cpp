@@ -0,0 +1,311 @@
+#include "GateServer.h"
+
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CommandQueue.h"
+#include "GateProtocol.h"
+#include "ParkingSnapshot.h"
+#include "ParkingSystem.h"
+
+// One gate controller. All members are only touched on the io thread;
+// CommandQueue completions are posted back to it.
+class GateServer::Connection : public std::enable_shared_from_this<GateServer::Connection>
+{
+private:
+    GateServer& server;
+    asio::ip::tcp::socket socket;
+
+    std::vector<unsigned char> input;
+    std::size_t inputUsed;
+    bool reading;
+
+    std::string outbox;   // encoded replies not yet handed to a write
+    std::string sending;  // replies owned by the write in flight
+    bool writing;
+    bool flushScheduled;
+
+    int inFlight;
+    bool closed;
+
+public:
+    Connection(GateServer& server, asio::ip::tcp::socket socket)
+        : server(server), socket(std::move(socket)), input(READ_BYTES), inputUsed(0), reading(false),
+          writing(false), flushScheduled(false), inFlight(0), closed(false)
+    {
+    }
+
+    void start()
+    {
+        // Replies are small and latency-sensitive.
+        asio::error_code ignored;
+        socket.set_option(asio::ip::tcp::no_delay(true), ignored);
+        read();
+    }
+
+private:
+    void read()
+    {
+        reading = true;
+        auto self = shared_from_this();
+        socket.async_read_some(asio::buffer(input.data() + inputUsed, input.size() - inputUsed),
+            [self](const asio::error_code& ec, std::size_t bytes)
+            {
+                self->reading = false;
+                if (ec || self->closed)
+                {
+                    self->close();
+                    return;
+                }
+
+                self->inputUsed += bytes;
+                self->decodeFrames();
+
+                // Backpressure: stop reading while too much is queued;
+                // complete() resumes once replies catch up.
+                if (self->inFlight < MAX_IN_FLIGHT)
+                {
+                    self->read();
+                }
+            });
+    }
+
+    // Dispatches every complete frame in the buffer and keeps the partial
+    // tail (if any) for the next read.
+    void decodeFrames()
+    {
+        std::size_t offset = 0;
+        while (inputUsed - offset >= GateProtocol::REQUEST_BYTES)
+        {
+            dispatch(GateProtocol::decodeRequest(input.data() + offset));
+            offset += GateProtocol::REQUEST_BYTES;
+        }
+
+        std::memmove(input.data(), input.data() + offset, inputUsed - offset);
+        inputUsed -= offset;
+    }
+
+    void dispatch(const GateProtocol::Request& request)
+    {
+        GateProtocol::Reply reply;
+        reply.op = request.op;
+        reply.tag = request.tag;
+
+        if (!request.valid)
+        {
+            reply.status = GateProtocol::BAD_FRAME;
+            send(reply);
+            return;
+        }
+
+        if (request.op != GateProtocol::REQUEST &&
+            (request.arg < 0 || request.arg >= server.system.getSnapshot()->requestCount))
+        {
+            reply.requestId = request.arg;
+            reply.status = GateProtocol::NOT_FOUND;
+            send(reply);
+            return;
+        }
+
+        auto self = shared_from_this();
+        std::uint8_t op = request.op;
+        std::uint32_t tag = request.tag;
+        int arg = request.arg;
+        CommandQueue::Done done = [self, op, tag, arg](int result)
+        {
+            asio::post(self->server.io, [self, op, tag, arg, result]()
+            {
+                self->complete(op, tag, arg, result);
+            });
+        };
+
+        bool queued = false;
+        switch (op)
+        {
+        case GateProtocol::REQUEST:
+            queued = server.queue.requestParking(std::string(request.vehicleId), arg, std::move(done));
+            break;
+        case GateProtocol::OCCUPY:
+            queued = server.queue.occupySlot(arg, std::move(done));
+            break;
+        case GateProtocol::RELEASE:
+            queued = server.queue.releaseSlot(arg, std::move(done));
+            break;
+        case GateProtocol::CANCEL:
+            queued = server.queue.cancelRequest(arg, std::move(done));
+            break;
+        }
+
+        if (!queued)
+        {
+            reply.status = GateProtocol::BUSY;
+            send(reply);
+            return;
+        }
+        ++inFlight;
+    }
+
+    // Runs on the io thread once the command has been applied and published.
+    void complete(std::uint8_t op, std::uint32_t tag, int arg, int result)
+    {
+        --inFlight;
+
+        GateProtocol::Reply reply;
+        reply.op = op;
+        reply.tag = tag;
+
+        int requestId = op == GateProtocol::REQUEST ? result : arg;
+        bool applied = op == GateProtocol::REQUEST ? result >= 0 : result == 1;
+        reply.status = applied ? GateProtocol::OK : GateProtocol::REJECTED;
+
+        if (requestId >= 0)
+        {
+            // The snapshot may already include later pipelined ops from the
+            // same batch, so a successful op reports the state it produced.
+            auto snapshot = server.system.getSnapshot();
+            const RequestRecord& record = snapshot->getRequest(requestId);
+            reply.requestId = record.requestId;
+            reply.state = static_cast<std::uint8_t>(applied ? stateAfter(op) : record.state);
+            reply.zoneId = record.allocatedZoneId;
+            reply.slotId = record.allocatedSlotId;
+        }
+
+        send(reply);
+
+        if (!reading && !closed && inFlight <= MAX_IN_FLIGHT / 2)
+        {
+            read();
+        }
+    }
+
+    static ParkingRequest::State stateAfter(std::uint8_t op)
+    {
+        switch (op)
+        {
+        case GateProtocol::OCCUPY: return ParkingRequest::State::OCCUPIED;
+        case GateProtocol::RELEASE: return ParkingRequest::State::RELEASED;
+        case GateProtocol::CANCEL: return ParkingRequest::State::CANCELLED;
+        default: return ParkingRequest::State::ALLOCATED;  // requestParking allocates at once
+        }
+    }
+
+    // Replies are appended to the outbox and written by a posted flush, so
+    // every reply produced in the same round of io handlers (typically a
+    // whole CommandQueue batch) goes out in one write.
+    void send(const GateProtocol::Reply& reply)
+    {
+        if (closed)
+        {
+            return;
+        }
+
+        GateProtocol::appendReply(outbox, reply);
+        if (!writing && !flushScheduled)
+        {
+            flushScheduled = true;
+            auto self = shared_from_this();
+            asio::post(server.io, [self]() { self->flush(); });
+        }
+    }
+
+    void flush()
+    {
+        flushScheduled = false;
+        if (closed || writing || outbox.empty())
+        {
+            return;
+        }
+
+        writing = true;
+        sending.swap(outbox);
+        outbox.clear();
+
+        auto self = shared_from_this();
+        asio::async_write(socket, asio::buffer(sending),
+            [self](const asio::error_code& ec, std::size_t)
+            {
+                self->writing = false;
+                self->sending.clear();
+                if (ec)
+                {
+                    self->close();
+                    return;
+                }
+
+                if (!self->outbox.empty())
+                {
+                    self->flush();
+                }
+            });
+    }
+
+    void close()
+    {
+        if (closed)
+        {
+            return;
+        }
+        closed = true;
+        outbox.clear();
+        asio::error_code ignored;
+        socket.shutdown(asio::ip::tcp::socket::shutdown_both, ignored);
+        socket.close(ignored);
+    }
+};
+
+GateServer::GateServer(ParkingSystem& system, CommandQueue& queue, unsigned short port)
+    : system(system),
+      queue(queue),
+      acceptor(io, asio::ip::tcp::endpoint(asio::ip::tcp::v4(), port))
+{
+}
+
+GateServer::~GateServer()
+{
+    stop();
+}
+
+void GateServer::start()
+{
+    accept();
+    worker = std::thread([this]()
+    {
+        try
+        {
+            io.run();
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "GateServer error: " << e.what() << std::endl;
+        }
+    });
+}
+
+void GateServer::stop()
+{
+    io.stop();
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+void GateServer::accept()
+{
+    acceptor.async_accept(
+        [this](const asio::error_code& ec, asio::ip::tcp::socket socket)
+        {
+            if (!ec)
+            {
+                std::make_shared<Connection>(*this, std::move(socket))->start();
+            }
+
+            if (acceptor.is_open())
+            {
+                accept();
+            }
+        });
+}
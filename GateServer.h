@@ -0,0 +1,56 @@
+#ifndef GATE_SERVER_H
+#define GATE_SERVER_H
+
+#include <cstddef>
+#include <thread>
+
+#ifndef ASIO_STANDALONE
+#define ASIO_STANDALONE
+#endif
+#include <asio.hpp>
+
+class CommandQueue;
+class ParkingSystem;
+
+// TCP listener for gate controllers speaking GateProtocol.
+//
+// A gate opens one persistent connection and pipelines fixed-size frames
+// over it. Each readable chunk is decoded in place, every complete frame is
+// handed to the CommandQueue without waiting for the previous one, and
+// replies produced while a write is still in flight are coalesced into the
+// next write. A busy gate therefore pays one syscall per burst rather than
+// one HTTP request/response (and its header parsing) per operation.
+//
+// Runs on its own io_context and thread, alongside the Crow app.
+class GateServer
+{
+public:
+    // Bytes read from a socket per read call.
+    static const std::size_t READ_BYTES = 16 * 1024;
+
+    // A connection with this many queued operations stops reading until
+    // half of them have been answered.
+    static const int MAX_IN_FLIGHT = 1024;
+
+    GateServer(ParkingSystem& system, CommandQueue& queue, unsigned short port);
+    ~GateServer();
+
+    GateServer(const GateServer&) = delete;
+    GateServer& operator=(const GateServer&) = delete;
+
+    void start();
+    void stop();
+
+private:
+    class Connection;
+
+    ParkingSystem& system;
+    CommandQueue& queue;
+    asio::io_context io;
+    asio::ip::tcp::acceptor acceptor;
+    std::thread worker;
+
+    void accept();
+};
+
+#endif  // GATE_SERVER_H
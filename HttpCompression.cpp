@@ -0,0 +1,117 @@
+#include "HttpCompression.h"
+
+#include <cctype>
+#include <cstdlib>
+
+#include "server/Crow-master/include/crow/compression.h"
+
+namespace
+{
+    std::string_view trim(std::string_view s)
+    {
+        while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front())))
+        {
+            s.remove_prefix(1);
+        }
+        while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back())))
+        {
+            s.remove_suffix(1);
+        }
+        return s;
+    }
+
+    bool equalsIgnoreCase(std::string_view a, std::string_view b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            if (std::tolower(static_cast<unsigned char>(a[i])) != b[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // "gzip;q=0" -> true. Anything else (no q, q>0) is acceptable.
+    bool rejected(std::string_view params)
+    {
+        std::size_t q = params.find("q=");
+        if (q == std::string_view::npos)
+        {
+            return false;
+        }
+        std::string value(trim(params.substr(q + 2)));
+        return std::strtod(value.c_str(), nullptr) <= 0.0;
+    }
+}
+
+HttpCompression::Encoding HttpCompression::negotiate(std::string_view acceptEncoding)
+{
+    // -1: not listed, 0: refused (q=0), 1: accepted
+    int gzip = -1;
+    int deflate = -1;
+    int any = -1;
+
+    while (!acceptEncoding.empty())
+    {
+        std::size_t comma = acceptEncoding.find(',');
+        std::string_view item = acceptEncoding.substr(0, comma);
+        acceptEncoding = comma == std::string_view::npos
+                             ? std::string_view()
+                             : acceptEncoding.substr(comma + 1);
+
+        std::size_t semicolon = item.find(';');
+        std::string_view coding = trim(item.substr(0, semicolon));
+        int ok = semicolon == std::string_view::npos || !rejected(item.substr(semicolon + 1));
+
+        if (equalsIgnoreCase(coding, "gzip") || equalsIgnoreCase(coding, "x-gzip"))
+        {
+            gzip = ok;
+        }
+        else if (equalsIgnoreCase(coding, "deflate"))
+        {
+            deflate = ok;
+        }
+        else if (coding == "*")
+        {
+            any = ok;
+        }
+    }
+
+    if (gzip == 1 || (gzip == -1 && any == 1))
+    {
+        return GZIP;
+    }
+    if (deflate == 1 || (deflate == -1 && any == 1))
+    {
+        return DEFLATE;
+    }
+    return IDENTITY;
+}
+
+bool HttpCompression::compress(const std::string& body, Encoding encoding, std::string& out)
+{
+    if (encoding == IDENTITY || body.size() < MIN_BYTES)
+    {
+        return false;
+    }
+
+    std::string compressed = crow::compression::compress_string(
+        body, encoding == GZIP ? crow::compression::GZIP : crow::compression::DEFLATE);
+    if (compressed.empty())
+    {
+        return false;
+    }
+
+    out = std::move(compressed);
+    return true;
+}
+
+const char* HttpCompression::headerValue(Encoding encoding)
+{
+    return encoding == GZIP ? "gzip" : encoding == DEFLATE ? "deflate" : "identity";
+}
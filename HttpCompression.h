@@ -0,0 +1,36 @@
+#ifndef HTTP_COMPRESSION_H
+#define HTTP_COMPRESSION_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Content-Encoding negotiation and compression for JSON response bodies,
+// built on Crow's compression.h (zlib). Requires CROW_ENABLE_COMPRESSION.
+class HttpCompression
+{
+public:
+    enum Encoding
+    {
+        IDENTITY,
+        GZIP,
+        DEFLATE
+    };
+
+    // Bodies smaller than this are sent as-is: the gzip header and the CPU
+    // cost outweigh the saving.
+    static const std::size_t MIN_BYTES = 1024;
+
+    // Picks an encoding from an Accept-Encoding header. gzip is preferred
+    // over deflate; codings with q=0 are never chosen.
+    static Encoding negotiate(std::string_view acceptEncoding);
+
+    // Compresses body into out. Returns false (out untouched) for IDENTITY,
+    // bodies below MIN_BYTES, or a zlib failure.
+    static bool compress(const std::string& body, Encoding encoding, std::string& out);
+
+    // Value for the Content-Encoding header ("gzip" / "deflate").
+    static const char* headerValue(Encoding encoding);
+};
+
+#endif  // HTTP_COMPRESSION_H
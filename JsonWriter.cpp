@@ -0,0 +1,218 @@
+#include "JsonWriter.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+    // Reused by every default-constructed writer on this thread.
+    thread_local std::string threadBuffer;
+
+    const std::uint64_t ONES = 0x0101010101010101ULL;
+    const std::uint64_t HIGH_BITS = 0x8080808080808080ULL;
+
+    // Checks 8 bytes at once for anything JSON requires escaping:
+    // control characters (< 0x20), '"' and '\\'.
+    // May report false positives only in words that really contain such a
+    // byte, which is fine because the caller re-scans those words bytewise.
+    inline bool wordNeedsEscape(std::uint64_t w)
+    {
+        std::uint64_t control = (w - ONES * 0x20) & ~w & HIGH_BITS;
+        std::uint64_t quote = w ^ (ONES * '"');
+        std::uint64_t backslash = w ^ (ONES * '\\');
+        quote = (quote - ONES) & ~quote & HIGH_BITS;
+        backslash = (backslash - ONES) & ~backslash & HIGH_BITS;
+        return (control | quote | backslash) != 0;
+    }
+
+    inline bool byteNeedsEscape(unsigned char c)
+    {
+        return c < 0x20 || c == '"' || c == '\\';
+    }
+}
+
+JsonWriter::JsonWriter()
+    : out(threadBuffer), needComma(false)
+{
+    out.clear();
+}
+
+JsonWriter::JsonWriter(std::string& buffer)
+    : out(buffer), needComma(false)
+{
+}
+
+void JsonWriter::separator()
+{
+    if (needComma)
+    {
+        out.push_back(',');
+    }
+}
+
+void JsonWriter::appendEscaped(std::string_view s)
+{
+    static const char HEX[] = "0123456789ABCDEF";
+
+    const char* data = s.data();
+    const std::size_t n = s.size();
+    std::size_t runStart = 0;
+    std::size_t i = 0;
+
+    while (i < n)
+    {
+        // Fast path: skip whole 8-byte words that need no escaping.
+        while (i + 8 <= n)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            if (wordNeedsEscape(word))
+            {
+                break;
+            }
+            i += 8;
+        }
+
+        // Slow path: at most one word (or the tail) byte by byte.
+        std::size_t stop = (i + 8 <= n) ? i + 8 : n;
+        for (; i < stop; ++i)
+        {
+            unsigned char c = static_cast<unsigned char>(data[i]);
+            if (!byteNeedsEscape(c))
+            {
+                continue;
+            }
+
+            out.append(data + runStart, i - runStart);
+            runStart = i + 1;
+
+            switch (c)
+            {
+            case '\\': out.append("\\\\", 2); break;
+            case '"': out.append("\\\"", 2); break;
+            case '\n': out.append("\\n", 2); break;
+            case '\r': out.append("\\r", 2); break;
+            case '\t': out.append("\\t", 2); break;
+            default:
+            {
+                char esc[6] = { '\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0x0F] };
+                out.append(esc, sizeof(esc));
+            }
+            }
+        }
+    }
+
+    out.append(data + runStart, n - runStart);
+}
+
+JsonWriter& JsonWriter::beginObject()
+{
+    separator();
+    out.push_back('{');
+    needComma = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::endObject()
+{
+    out.push_back('}');
+    needComma = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::beginArray()
+{
+    separator();
+    out.push_back('[');
+    needComma = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::endArray()
+{
+    out.push_back(']');
+    needComma = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(std::string_view name)
+{
+    separator();
+    out.push_back('"');
+    out.append(name.data(), name.size());
+    out.append("\":", 2);
+    needComma = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(double v)
+{
+    if (!std::isfinite(v))
+    {
+        return null();
+    }
+
+    separator();
+    char digits[32];
+    auto result = std::to_chars(digits, digits + sizeof(digits), v, std::chars_format::general, 15);
+    out.append(digits, static_cast<std::size_t>(result.ptr - digits));
+    needComma = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool v)
+{
+    separator();
+    if (v)
+    {
+        out.append("true", 4);
+    }
+    else
+    {
+        out.append("false", 5);
+    }
+    needComma = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(std::string_view s)
+{
+    separator();
+    out.push_back('"');
+    appendEscaped(s);
+    out.push_back('"');
+    needComma = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(const char* s)
+{
+    return value(std::string_view(s));
+}
+
+JsonWriter& JsonWriter::null()
+{
+    separator();
+    out.append("null", 4);
+    needComma = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::raw(std::string_view json)
+{
+    separator();
+    out.append(json.data(), json.size());
+    needComma = true;
+    return *this;
+}
+
+const std::string& JsonWriter::buffer() const
+{
+    return out;
+}
+
+std::string JsonWriter::str() const
+{
+    return out;
+}
@@ -0,0 +1,82 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Small append-only JSON writer used by the HTTP layer.
+//
+// Output goes straight into a growable byte buffer. By default that buffer is
+// thread-local and keeps its capacity between responses, so once a worker
+// thread has warmed up, serializing a response performs no per-field heap
+// allocations. Commas are inserted automatically between values.
+//
+// Only one default-constructed writer may be live per thread at a time, since
+// they all share the same thread-local buffer.
+class JsonWriter
+{
+private:
+    std::string& out;
+    bool needComma;
+
+    void separator();
+    void appendEscaped(std::string_view s);
+
+public:
+    // Writes into the calling thread's reusable buffer (cleared on construction).
+    JsonWriter();
+
+    // Writes into a caller-owned buffer (appends to existing contents).
+    explicit JsonWriter(std::string& buffer);
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+
+    // Object member name. Names are expected to be plain ASCII literals and
+    // are written without escaping.
+    JsonWriter& key(std::string_view name);
+
+    // Integers are formatted with std::to_chars (no locale, no allocation).
+    template <typename T,
+              typename = std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>>
+    JsonWriter& value(T v)
+    {
+        separator();
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), v);
+        out.append(digits, static_cast<std::size_t>(result.ptr - digits));
+        needComma = true;
+        return *this;
+    }
+
+    // Doubles use std::to_chars with 15 significant digits, so the decimal
+    // point never follows the C locale. JSON has no NaN or Infinity; those
+    // are written as null.
+    JsonWriter& value(double v);
+    JsonWriter& value(bool v);
+    JsonWriter& value(std::string_view s);
+    JsonWriter& value(const char* s);
+    JsonWriter& null();
+
+    // Appends an already-serialized JSON fragment as a single value.
+    JsonWriter& raw(std::string_view json);
+
+    // Convenience: key(name).value(v)
+    template <typename T>
+    JsonWriter& field(std::string_view name, const T& v)
+    {
+        key(name);
+        return value(v);
+    }
+
+    const std::string& buffer() const;
+
+    // Copies the serialized document out (one exact-size allocation).
+    std::string str() const;
+};
+
+#endif  // JSON_WRITER_H
@@ -0,0 +1,451 @@
+#include "OccupancyArchive.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <system_error>
+
+#include "ParkingSystem.h"
+
+namespace
+{
+    const std::size_t PAYLOAD_BITS = (OccupancyArchive::BLOCK_BYTES - OccupancyArchive::HEADER_BYTES) * 8;
+
+    // Longest encoding of one sample: 4 + 32 time bits, 3 + 32 value bits.
+    const std::size_t MAX_SAMPLE_BITS = 71;
+
+    void putU32(unsigned char* out, std::uint32_t v)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            out[i] = static_cast<unsigned char>(v >> (8 * i));
+        }
+    }
+
+    void putI64(unsigned char* out, long long v)
+    {
+        std::uint64_t u = static_cast<std::uint64_t>(v);
+        for (int i = 0; i < 8; ++i)
+        {
+            out[i] = static_cast<unsigned char>(u >> (8 * i));
+        }
+    }
+
+    std::uint32_t getU32(const unsigned char* in)
+    {
+        std::uint32_t v = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            v |= static_cast<std::uint32_t>(in[i]) << (8 * i);
+        }
+        return v;
+    }
+
+    long long getI64(const unsigned char* in)
+    {
+        std::uint64_t v = 0;
+        for (int i = 0; i < 8; ++i)
+        {
+            v |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+        }
+        return static_cast<long long>(v);
+    }
+
+    std::uint64_t zigzag(long long v)
+    {
+        return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+    }
+
+    long long unzigzag(std::uint64_t v)
+    {
+        return static_cast<long long>(v >> 1) ^ -static_cast<long long>(v & 1);
+    }
+
+    void putBits(unsigned char* payload, std::size_t& pos, std::uint64_t value, int width)
+    {
+        for (int i = width - 1; i >= 0; --i, ++pos)
+        {
+            if ((value >> i) & 1)
+            {
+                payload[pos / 8] |= static_cast<unsigned char>(0x80 >> (pos % 8));
+            }
+        }
+    }
+
+    std::uint64_t getBits(const unsigned char* payload, std::size_t& pos, int width)
+    {
+        std::uint64_t value = 0;
+        for (int i = 0; i < width; ++i, ++pos)
+        {
+            value = (value << 1) | ((payload[pos / 8] >> (7 - pos % 8)) & 1);
+        }
+        return value;
+    }
+
+    // Number of leading 1 bits (at most `limit`), consuming the 0 after them.
+    int getPrefix(const unsigned char* payload, std::size_t& pos, int limit)
+    {
+        int ones = 0;
+        while (ones < limit && getBits(payload, pos, 1) == 1)
+        {
+            ++ones;
+        }
+        return ones;
+    }
+
+    const int TIME_WIDTHS[] = { 0, 7, 9, 12, 32 };
+    const int VALUE_WIDTHS[] = { 0, 6, 12, 32 };
+
+    // Smallest bucket of `widths` that holds z.
+    int bucketFor(std::uint64_t z, const int* widths, int buckets)
+    {
+        int bucket = 0;
+        while (bucket < buckets - 1 && (widths[bucket] == 0 ? z != 0 : (z >> widths[bucket]) != 0))
+        {
+            ++bucket;
+        }
+        return bucket;
+    }
+
+    void putBucket(unsigned char* payload, std::size_t& pos, std::uint64_t z, int bucket, const int* widths,
+                   int buckets)
+    {
+        // `bucket` ones, then a 0 unless it is the last bucket.
+        for (int i = 0; i < bucket; ++i)
+        {
+            putBits(payload, pos, 1, 1);
+        }
+        if (bucket < buckets - 1)
+        {
+            putBits(payload, pos, 0, 1);
+        }
+        putBits(payload, pos, z, widths[bucket]);
+    }
+}
+
+OccupancyArchive::OccupancyArchive(ParkingSystem& system, const std::string& path,
+                                   std::chrono::seconds sampleInterval)
+    : system(system),
+      path(path),
+      sampleInterval(sampleInterval),
+      running(false),
+      fileSize(0)
+{
+}
+
+OccupancyArchive::~OccupancyArchive()
+{
+    stop();
+}
+
+bool OccupancyArchive::start()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running)
+    {
+        return true;
+    }
+
+    if (!file.is_open() && !load())
+    {
+        return false;
+    }
+
+    running = true;
+    worker = std::thread(&OccupancyArchive::run, this);
+    return true;
+}
+
+void OccupancyArchive::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wake.notify_all();
+
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : zones)
+    {
+        if (entry.second.open.count > 0)
+        {
+            seal(entry.second);
+        }
+    }
+    file.close();
+}
+
+bool OccupancyArchive::load()
+{
+    // A torn block at the end (crash mid-write) is dropped so appends stay
+    // block-aligned.
+    std::error_code error;
+    std::uintmax_t size = std::filesystem::file_size(path, error);
+    if (!error && size % BLOCK_BYTES != 0)
+    {
+        std::filesystem::resize_file(path, size - size % BLOCK_BYTES, error);
+        if (error)
+        {
+            return false;
+        }
+    }
+
+    // Open blocks are rewritten in place, so no ios::app; create the file
+    // first since in|out will not.
+    std::ofstream(path, std::ios::binary | std::ios::app).close();
+    file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    file.seekg(0, std::ios::end);
+    fileSize = file.tellg();
+
+    unsigned char header[HEADER_BYTES];
+    for (std::streamoff offset = 0; offset + static_cast<std::streamoff>(BLOCK_BYTES) <= fileSize;
+         offset += BLOCK_BYTES)
+    {
+        file.seekg(offset);
+        if (!file.read(reinterpret_cast<char*>(header), HEADER_BYTES))
+        {
+            break;
+        }
+        if (getU32(header) != BLOCK_MAGIC || getU32(header + 8) == 0)
+        {
+            continue;  // not a block; skip it rather than lose what follows
+        }
+
+        int zoneId = static_cast<int>(getU32(header + 4));
+        zones[zoneId].sealed.push_back(BlockRef{ getI64(header + 16), getI64(header + 24), offset });
+    }
+
+    file.clear();
+    return true;
+}
+
+void OccupancyArchive::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running)
+    {
+        lock.unlock();
+        sample();
+        lock.lock();
+
+        wake.wait_for(lock, sampleInterval);
+    }
+}
+
+void OccupancyArchive::sample()
+{
+    // O(zones): the snapshot already has every zone's occupied count.
+    std::shared_ptr<const ParkingSnapshot> snapshot = system.getSnapshot();
+    long long now = static_cast<long long>(std::time(nullptr));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& zone : snapshot->zones)
+    {
+        appendLocked(zone->zoneId, now, zone->occupiedSlots);
+    }
+    file.flush();
+}
+
+void OccupancyArchive::append(int zoneId, long long time, int occupied)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    appendLocked(zoneId, time, occupied);
+    file.flush();
+}
+
+void OccupancyArchive::appendLocked(int zoneId, long long time, int occupied)
+{
+    if (!file.is_open())
+    {
+        return;
+    }
+
+    ZoneSeries& series = zones[zoneId];
+    OpenBlock& block = series.open;
+
+    // Blocks must not overlap in time for the index search to hold.
+    long long newest = block.count > 0 ? block.lastTime
+                     : !series.sealed.empty() ? series.sealed.back().lastTime
+                     : -1;
+    if (time <= newest)
+    {
+        return;
+    }
+
+    std::uint64_t timeBits = 0;
+    std::uint64_t valueBits = 0;
+    if (block.count > 0)
+    {
+        long long delta = time - block.lastTime;
+        timeBits = zigzag(delta - block.lastDelta);
+        valueBits = zigzag(static_cast<long long>(occupied) - block.lastValue);
+
+        if ((timeBits >> 32) != 0 || block.bitCount + MAX_SAMPLE_BITS > PAYLOAD_BITS ||
+            time - block.firstTime > BLOCK_SPAN)
+        {
+            seal(series);
+        }
+    }
+
+    unsigned char* payload = block.bytes + HEADER_BYTES;
+    if (block.count == 0)
+    {
+        std::memset(block.bytes, 0, BLOCK_BYTES);
+        putU32(block.bytes, BLOCK_MAGIC);
+        putU32(block.bytes + 4, static_cast<std::uint32_t>(zoneId));
+        putI64(block.bytes + 16, time);
+        putU32(block.bytes + 32, static_cast<std::uint32_t>(occupied));
+
+        block.bitCount = 0;
+        block.firstTime = time;
+        block.lastDelta = 0;
+        block.offset = -1;
+    }
+    else
+    {
+        putBucket(payload, block.bitCount, timeBits, bucketFor(timeBits, TIME_WIDTHS, 5), TIME_WIDTHS, 5);
+        putBucket(payload, block.bitCount, valueBits, bucketFor(valueBits, VALUE_WIDTHS, 4), VALUE_WIDTHS, 4);
+        block.lastDelta = time - block.lastTime;
+    }
+
+    block.count += 1;
+    block.lastTime = time;
+    block.lastValue = occupied;
+
+    // Keep the header current so the open block decodes like a sealed one.
+    putU32(block.bytes + 8, static_cast<std::uint32_t>(block.count));
+    putU32(block.bytes + 12, static_cast<std::uint32_t>(block.bitCount));
+    putI64(block.bytes + 24, time);
+
+    writeOpen(block);
+}
+
+bool OccupancyArchive::writeOpen(OpenBlock& block)
+{
+    bool placed = block.offset >= 0;
+
+    file.clear();
+    file.seekp(placed ? block.offset : fileSize);
+    file.write(reinterpret_cast<const char*>(block.bytes), BLOCK_BYTES);
+    if (!file)
+    {
+        // Disk full or similar: keep the block in memory and try again on
+        // the next sample.
+        file.clear();
+        if (!placed)
+        {
+            std::error_code error;
+            std::filesystem::resize_file(path, static_cast<std::uintmax_t>(fileSize), error);
+        }
+        return false;
+    }
+
+    if (!placed)
+    {
+        block.offset = fileSize;
+        fileSize += BLOCK_BYTES;
+    }
+    return true;
+}
+
+void OccupancyArchive::seal(ZoneSeries& series)
+{
+    OpenBlock& block = series.open;
+
+    // Normally a no-op rewrite. If it fails, the file keeps the block as
+    // of its last successful write; a block that never got written is lost.
+    writeOpen(block);
+    file.flush();
+    file.clear();
+
+    if (block.offset >= 0)
+    {
+        series.sealed.push_back(BlockRef{ block.firstTime, block.lastTime, block.offset });
+    }
+
+    block.count = 0;
+}
+
+int OccupancyArchive::query(int zoneId, long long from, long long to, std::vector<Sample>& out)
+{
+    out.clear();
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto found = zones.find(zoneId);
+    if (found == zones.end() || from > to)
+    {
+        return 0;
+    }
+
+    const ZoneSeries& series = found->second;
+    int decoded = 0;
+
+    // First block that ends at or after `from`; blocks are in time order.
+    auto first = std::lower_bound(series.sealed.begin(), series.sealed.end(), from,
+        [](const BlockRef& block, long long time) { return block.lastTime < time; });
+
+    unsigned char bytes[BLOCK_BYTES];
+    for (auto it = first; it != series.sealed.end() && it->firstTime <= to; ++it)
+    {
+        file.clear();
+        file.seekg(it->offset);
+        if (!file.read(reinterpret_cast<char*>(bytes), BLOCK_BYTES))
+        {
+            break;
+        }
+        decode(bytes, from, to, out);
+        ++decoded;
+    }
+    file.clear();
+
+    const OpenBlock& open = series.open;
+    if (open.count > 0 && open.lastTime >= from && open.firstTime <= to)
+    {
+        decode(open.bytes, from, to, out);
+        ++decoded;
+    }
+
+    return decoded;
+}
+
+void OccupancyArchive::decode(const unsigned char* block, long long from, long long to, std::vector<Sample>& out)
+{
+    const unsigned char* payload = block + HEADER_BYTES;
+    std::uint32_t count = getU32(block + 8);
+
+    long long time = getI64(block + 16);
+    long long delta = 0;
+    long long value = static_cast<int>(getU32(block + 32));
+    std::size_t pos = 0;
+
+    for (std::uint32_t i = 0; i < count && time <= to; ++i)
+    {
+        if (i > 0)
+        {
+            int bucket = getPrefix(payload, pos, 4);
+            delta += unzigzag(getBits(payload, pos, TIME_WIDTHS[bucket]));
+            time += delta;
+
+            bucket = getPrefix(payload, pos, 3);
+            value += unzigzag(getBits(payload, pos, VALUE_WIDTHS[bucket]));
+        }
+
+        if (time >= from && time <= to)
+        {
+            out.push_back(Sample{ time, static_cast<int>(value) });
+        }
+    }
+}
@@ -0,0 +1,133 @@
+#ifndef OCCUPANCY_ARCHIVE_H
+#define OCCUPANCY_ARCHIVE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class ParkingSystem;
+
+// Long-term per-zone occupancy history, sampled at a fixed interval and
+// kept in a file of compressed fixed-size blocks.
+//
+// Each zone's samples go into its own BLOCK_BYTES block:
+//    0  u32  magic      BLOCK_MAGIC
+//    4  i32  zoneId
+//    8  u32  count      samples in the block
+//   12  u32  bits       payload bits used
+//   16  i64  firstTime  seconds since epoch
+//   24  i64  lastTime
+//   32  i32  firstValue occupied slots
+//   36  u32  reserved   0
+//   40  payload: samples 2..count, MSB first
+// (little-endian). A sample's timestamp is stored as the change in its
+// delta from the previous one (zero for a steady sampling interval) and
+// its value as the change from the previous value, both zigzag-encoded
+// into variable-width buckets:
+//   time:  0 | 10 +7 bits | 110 +9 | 1110 +12 | 1111 +32
+//   value: 0 | 10 +6 bits | 110 +12 | 111 +32
+// so a quiet zone costs 2 bits per sample.
+//
+// A zone's open block takes its place at the end of the file with its
+// first sample and is rewritten there, header included, as samples
+// arrive; the file is flushed once per sampling round. A crash therefore
+// loses at most one sample interval, and the open block it leaves behind
+// reads back as a sealed one. A block is sealed (left as it is; the next
+// sample starts a new one) when the next sample might not fit, when it
+// spans BLOCK_SPAN, or on stop(). Sealed blocks are never rewritten. At
+// start() only block headers are read, to rebuild an in-memory index of
+// each zone's blocks, and a range query decodes only the blocks whose
+// [firstTime, lastTime] overlaps it.
+class OccupancyArchive
+{
+public:
+    static const std::size_t BLOCK_BYTES = 256;
+    static const std::size_t HEADER_BYTES = 40;
+    static const unsigned int BLOCK_MAGIC = 0x4F434342;  // "BCCO"
+
+    static const long long BLOCK_SPAN = 6 * 3600;  // seconds
+
+    struct Sample
+    {
+        long long time;  // seconds since epoch
+        int occupied;
+    };
+
+    OccupancyArchive(ParkingSystem& system, const std::string& path, std::chrono::seconds sampleInterval);
+    ~OccupancyArchive();
+
+    OccupancyArchive(const OccupancyArchive&) = delete;
+    OccupancyArchive& operator=(const OccupancyArchive&) = delete;
+
+    // Opens (or creates) the file, indexes the blocks already in it and
+    // starts sampling. False if the file cannot be opened.
+    bool start();
+
+    // Stops sampling and seals every open block.
+    void stop();
+
+    // Adds one sample. Samples older than the zone's last are dropped.
+    void append(int zoneId, long long time, int occupied);
+
+    // zoneId's samples with from <= time <= to, oldest first. Returns the
+    // number of blocks decoded (sealed and open).
+    int query(int zoneId, long long from, long long to, std::vector<Sample>& out);
+
+private:
+    struct BlockRef
+    {
+        long long firstTime;
+        long long lastTime;
+        std::streamoff offset;
+    };
+
+    // Block being filled for one zone.
+    struct OpenBlock
+    {
+        unsigned char bytes[BLOCK_BYTES];
+        std::size_t bitCount;
+        int count;
+        long long firstTime;
+        long long lastTime;
+        long long lastDelta;
+        int lastValue;
+        std::streamoff offset;  // place in the file; -1 until written
+    };
+
+    struct ZoneSeries
+    {
+        std::vector<BlockRef> sealed;  // in time order
+        OpenBlock open;                // count == 0 when empty
+    };
+
+    ParkingSystem& system;
+    std::string path;
+    std::chrono::seconds sampleInterval;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool running;
+    std::thread worker;
+
+    std::fstream file;
+    std::streamoff fileSize;
+    std::unordered_map<int, ZoneSeries> zones;
+
+    void run();
+    void sample();
+
+    bool load();
+    void appendLocked(int zoneId, long long time, int occupied);
+    bool writeOpen(OpenBlock& block);
+    void seal(ZoneSeries& series);
+
+    static void decode(const unsigned char* block, long long from, long long to, std::vector<Sample>& out);
+};
+
+#endif  // OCCUPANCY_ARCHIVE_H
@@ -0,0 +1,236 @@
+#include "OccupancyFeed.h"
+
+#include <algorithm>
+
+#include "server/Crow-master/include/crow.h"
+
+#include "JsonWriter.h"
+#include "ParkingSystem.h"
+
+OccupancyFeed::OccupancyFeed(ParkingSystem& system, std::chrono::milliseconds tickInterval)
+    : system(system),
+      tickInterval(tickInterval),
+      running(false),
+      lastSent(system.getSnapshot()),
+      snapshotMessageVersion(0)
+{
+}
+
+OccupancyFeed::~OccupancyFeed()
+{
+    stop();
+}
+
+void OccupancyFeed::start()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running)
+    {
+        return;
+    }
+
+    running = true;
+    worker = std::thread(&OccupancyFeed::run, this);
+}
+
+void OccupancyFeed::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wake.notify_all();
+
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+void OccupancyFeed::subscribe(crow::websocket::connection& conn)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // The snapshot must match lastSent so the next delta applies cleanly.
+    conn.send_text(currentSnapshotMessage());
+    subscribers.push_back(&conn);
+}
+
+void OccupancyFeed::unsubscribe(crow::websocket::connection& conn)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    subscribers.erase(std::remove(subscribers.begin(), subscribers.end(), &conn), subscribers.end());
+}
+
+void OccupancyFeed::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running)
+    {
+        wake.wait_for(lock, tickInterval);
+        if (!running)
+        {
+            break;
+        }
+        lock.unlock();
+        tick();
+        lock.lock();
+    }
+}
+
+void OccupancyFeed::tick()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::shared_ptr<const ParkingSnapshot> current = system.getSnapshot();
+    if (current->version == lastSent->version)
+    {
+        return;
+    }
+
+    // With nobody listening, just move the baseline forward.
+    if (!subscribers.empty())
+    {
+        buildDelta(*lastSent, *current);
+        for (crow::websocket::connection* conn : subscribers)
+        {
+            conn->send_text(deltaBuffer);
+        }
+    }
+
+    lastSent = current;
+}
+
+const std::string& OccupancyFeed::currentSnapshotMessage()
+{
+    if (snapshotMessageVersion == lastSent->version && !snapshotMessage.empty())
+    {
+        return snapshotMessage;
+    }
+
+    snapshotMessage.clear();
+    JsonWriter json(snapshotMessage);
+    json.beginObject()
+        .field("type", "snapshot")
+        .field("version", lastSent->version);
+    writeCounters(json, *lastSent);
+    json.key("zones").beginArray();
+    for (const auto& zone : lastSent->zones)
+    {
+        writeFullZone(json, *zone);
+    }
+    json.endArray().endObject();
+
+    snapshotMessageVersion = lastSent->version;
+    return snapshotMessage;
+}
+
+void OccupancyFeed::buildDelta(const ParkingSnapshot& previous, const ParkingSnapshot& current)
+{
+    deltaBuffer.clear();
+    JsonWriter json(deltaBuffer);
+    json.beginObject()
+        .field("type", "delta")
+        .field("version", current.version);
+    writeCounters(json, current);
+
+    const std::size_t shared = std::min(previous.zones.size(), current.zones.size());
+
+    // Zone counters for zones whose snapshot object was replaced.
+    json.key("zones").beginArray();
+    for (std::size_t z = 0; z < shared; ++z)
+    {
+        const ZoneSnapshot& zone = *current.zones[z];
+        if (&zone == previous.zones[z].get())
+        {
+            continue;
+        }
+        json.beginObject()
+            .field("id", zone.zoneId)
+            .field("capacity", zone.capacity)
+            .field("occupiedSlots", zone.occupiedSlots)
+            .endObject();
+    }
+    json.endArray();
+
+    // Slot flips inside those zones.
+    json.key("slots").beginArray();
+    for (std::size_t z = 0; z < shared; ++z)
+    {
+        const ZoneSnapshot& before = *previous.zones[z];
+        const ZoneSnapshot& after = *current.zones[z];
+        if (&before == &after || before.capacity != after.capacity)
+        {
+            continue;
+        }
+        const int leafSize = static_cast<int>(CowVector<int>::LEAF_SIZE);
+        for (int leaf = 0; leaf < after.capacity; leaf += leafSize)
+        {
+            // Holder leaves no update touched are still shared.
+            if (after.holders.sharesLeaf(before.holders, static_cast<std::size_t>(leaf)))
+            {
+                continue;
+            }
+            int end = std::min(leaf + leafSize, after.capacity);
+            for (int i = leaf; i < end; ++i)
+            {
+                if (before.isOccupied(i) != after.isOccupied(i))
+                {
+                    json.beginArray()
+                        .value(after.zoneId)
+                        .value(i)
+                        .value(after.isOccupied(i) ? 1 : 0)
+                        .endArray();
+                }
+            }
+        }
+    }
+    json.endArray();
+
+    // New zones (or zones whose layout changed) are sent in full.
+    json.key("added").beginArray();
+    for (std::size_t z = 0; z < current.zones.size(); ++z)
+    {
+        bool isNew = z >= shared ||
+                     previous.zones[z]->capacity != current.zones[z]->capacity;
+        if (isNew)
+        {
+            writeFullZone(json, *current.zones[z]);
+        }
+    }
+    json.endArray().endObject();
+}
+
+void OccupancyFeed::writeCounters(JsonWriter& json, const ParkingSnapshot& snapshot)
+{
+    json.field("totalSlots", snapshot.totalSlots)
+        .field("occupiedSlots", snapshot.occupiedSlots)
+        .field("activeRequests", snapshot.activeRequests);
+}
+
+void OccupancyFeed::writeFullZone(JsonWriter& json, const ZoneSnapshot& zone)
+{
+    json.beginObject()
+        .field("id", zone.zoneId)
+        .field("capacity", zone.capacity)
+        .field("occupiedSlots", zone.occupiedSlots)
+        .key("slotIds").beginArray();
+    for (const SlotLayout::Span& span : zone.layout->spans)
+    {
+        for (int k = 0; k < span.count; ++k)
+        {
+            json.value(span.firstSlotId + k);
+        }
+    }
+    json.endArray();
+
+    std::string occupancy(static_cast<std::size_t>(zone.capacity), '0');
+    for (int i = 0; i < zone.capacity; ++i)
+    {
+        if (zone.isOccupied(i))
+        {
+            occupancy[i] = '1';
+        }
+    }
+    json.field("occupancy", occupancy).endObject();
+}
@@ -0,0 +1,89 @@
+#ifndef OCCUPANCY_FEED_H
+#define OCCUPANCY_FEED_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ParkingSnapshot.h"
+
+class JsonWriter;
+class ParkingSystem;
+
+namespace crow
+{
+    namespace websocket
+    {
+        struct connection;
+    }
+}
+
+// Pushes occupancy to WebSocket subscribers.
+//
+// A new subscriber gets one full "snapshot" message. After that, once per
+// tick, the feed diffs the latest published ParkingSnapshot against the
+// last one it broadcast and sends a compact "delta" with only the slots
+// that changed. Several changes in one tick collapse into one delta. Since
+// snapshots are copy-on-write per zone, unchanged zones are skipped with a
+// pointer compare. Each delta is serialized once and the same text goes to
+// every subscriber.
+//
+// snapshot: {"type":"snapshot","version":V,<counters>,
+//            "zones":[{"id","capacity","occupiedSlots","slotIds":[..],"occupancy":"0110.."}]}
+// delta:    {"type":"delta","version":V,<counters>,
+//            "zones":[{"id","capacity","occupiedSlots"}],   // changed zones
+//            "slots":[[zoneId,slotIndex,occupied],..],       // slotIndex into slotIds
+//            "added":[<zone as in snapshot>]}                // new zones
+// <counters> = "totalSlots","occupiedSlots","activeRequests"
+class OccupancyFeed
+{
+private:
+    ParkingSystem& system;
+    std::chrono::milliseconds tickInterval;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool running;
+    std::thread worker;
+
+    std::vector<crow::websocket::connection*> subscribers;
+
+    // Everything broadcast so far describes exactly this snapshot.
+    std::shared_ptr<const ParkingSnapshot> lastSent;
+
+    // Full-state message for lastSent, built lazily once per version.
+    std::string snapshotMessage;
+    std::uint64_t snapshotMessageVersion;
+
+    // Reused for delta serialization.
+    std::string deltaBuffer;
+
+    void run();
+    void tick();
+    const std::string& currentSnapshotMessage();
+    void buildDelta(const ParkingSnapshot& previous, const ParkingSnapshot& current);
+
+    static void writeCounters(JsonWriter& json, const ParkingSnapshot& snapshot);
+    static void writeFullZone(JsonWriter& json, const ZoneSnapshot& zone);
+
+public:
+    OccupancyFeed(ParkingSystem& system, std::chrono::milliseconds tickInterval);
+    ~OccupancyFeed();
+
+    OccupancyFeed(const OccupancyFeed&) = delete;
+    OccupancyFeed& operator=(const OccupancyFeed&) = delete;
+
+    void start();
+    void stop();
+
+    // Called from the WebSocket route's onopen / onclose / onerror.
+    void subscribe(crow::websocket::connection& conn);
+    void unsubscribe(crow::websocket::connection& conn);
+};
+
+#endif  // OCCUPANCY_FEED_H
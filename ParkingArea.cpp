@@ -1,9 +1,85 @@
 
 #include "ParkingArea.h"
 
+SlotRef::SlotRef()
+    : area(nullptr), index(-1)
+{
+}
+
+SlotRef::SlotRef(ParkingArea* area, int index)
+    : area(area), index(index)
+{
+}
+
+SlotRef::operator bool() const
+{
+    return area != nullptr;
+}
+
+int SlotRef::getSlotId() const
+{
+    return area->getSlotId(index);
+}
+
+int SlotRef::getZoneId() const
+{
+    return area->zoneId;
+}
+
+bool SlotRef::getIsAvailable() const
+{
+    return area->slots[index].isAvailable();
+}
+
+void SlotRef::setIsAvailable(bool isAvailable)
+{
+    area->setAvailable(index, isAvailable);
+}
+
+void SlotRef::setRunAvailable(int count, bool isAvailable)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        area->setAvailable(index + i, isAvailable);
+    }
+}
+
+int SlotRef::getType() const
+{
+    return area->slots[index].getType();
+}
+
+void SlotRef::setType(int type)
+{
+    area->setType(index, type);
+}
+
+void SlotRef::reservePower(int watts)
+{
+    area->powerReserved += watts;
+}
+
+void SlotRef::releasePower(int watts)
+{
+    area->powerReserved -= watts;
+}
+
 ParkingArea::ParkingArea(int areaId)
-    : areaId(areaId)
+    : areaId(areaId), zoneId(-1), firstSlotId(0), indexesStale(true),
+      powerBudget(-1), powerReserved(0)
 {
+    typeTree.fill(NO_TREE);
+}
+
+ParkingArea::ParkingArea(int areaId, int zoneId, int firstSlotId, int slotCount, int type)
+    : areaId(areaId), zoneId(zoneId), firstSlotId(firstSlotId), indexesStale(true),
+      powerBudget(-1), powerReserved(0)
+{
+    typeTree.fill(NO_TREE);
+    if (slotCount > 0)
+    {
+        slots.assign(static_cast<std::size_t>(slotCount), PackedSlot(true, type));
+    }
 }
 
 int ParkingArea::getAreaId() const
@@ -11,21 +87,218 @@ int ParkingArea::getAreaId() const
     return areaId;
 }
 
+int ParkingArea::getZoneId() const
+{
+    return zoneId;
+}
+
 void ParkingArea::addParkingSlot(const ParkingSlot& slot)
 {
-    slots.push_back(slot);
+    if (slots.empty())
+    {
+        firstSlotId = slot.getSlotId();
+        zoneId = slot.getZoneId();
+    }
+
+    int nextId = firstSlotId + static_cast<int>(slots.size());
+    if (slotIds.empty() && slot.getSlotId() != nextId)
+    {
+        // First gap in the numbering: switch to explicit ids.
+        slotIds.reserve(slots.size() + 1);
+        for (int i = 0; i < static_cast<int>(slots.size()); ++i)
+        {
+            slotIds.push_back(firstSlotId + i);
+        }
+    }
+
+    if (!slotIds.empty())
+    {
+        slotIds.push_back(slot.getSlotId());
+    }
+    slots.push_back(PackedSlot(slot.getIsAvailable(), slot.getType()));
+    indexesStale = true;
+}
+
+void ParkingArea::setAvailable(int index, bool isAvailable)
+{
+    PackedSlot& slot = slots[index];
+    slot.setAvailable(isAvailable);
+    if (indexesStale)
+    {
+        return;
+    }
+
+    freeRuns.set(index, isAvailable);
+    int tree = typeTree[slot.getType()];
+    if (tree >= 0)
+    {
+        typeRuns[tree].set(index, isAvailable);
+    }
+}
+
+void ParkingArea::setType(int index, int type)
+{
+    if (slots[index].getType() != type)
+    {
+        slots[index].setType(type);
+        indexesStale = true;
+    }
+}
+
+void ParkingArea::refreshIndexes()
+{
+    if (!indexesStale)
+    {
+        return;
+    }
+
+    int count = static_cast<int>(slots.size());
+    freeRuns.build(count, [this](int i) { return slots[i].isAvailable(); });
+
+    typeTree.fill(NO_TREE);
+    int typesPresent = 0;
+    for (const PackedSlot& slot : slots)
+    {
+        if (typeTree[slot.getType()] == NO_TREE)
+        {
+            typeTree[slot.getType()] = ALL_TYPES;
+            typesPresent += 1;
+        }
+    }
+
+    typeRuns.clear();
+    if (typesPresent > 1)
+    {
+        typeRuns.reserve(static_cast<std::size_t>(typesPresent));
+        for (int type = 0; type <= PackedSlot::MAX_TYPE; ++type)
+        {
+            if (typeTree[type] == NO_TREE)
+            {
+                continue;
+            }
+            typeTree[type] = static_cast<std::int8_t>(typeRuns.size());
+            typeRuns.emplace_back();
+            typeRuns.back().build(count, [this, type](int i) {
+                return slots[i].isAvailable() && slots[i].getType() == type;
+            });
+        }
+    }
+
+    indexesStale = false;
+}
+
+SlotRef ParkingArea::getFirstAvailableSlot()
+{
+    return findFreeRun(1);
+}
+
+SlotRef ParkingArea::findFreeRun(int count)
+{
+    refreshIndexes();
+
+    int index = freeRuns.findRun(count);
+    return index >= 0 ? SlotRef(this, index) : SlotRef();
+}
+
+SlotRef ParkingArea::findFreeRun(int count, int type)
+{
+    refreshIndexes();
+
+    int index = peekFreeRun(count, type);
+    return index >= 0 ? SlotRef(this, index) : SlotRef();
+}
+
+SlotRef ParkingArea::findFreeOfType(int type)
+{
+    return findFreeRun(1, type);
+}
+
+int ParkingArea::peekFreeOfType(int type) const
+{
+    return peekFreeRun(1, type);
+}
+
+int ParkingArea::peekFreeRun(int count, int type) const
+{
+    if (type < 0 || type > PackedSlot::MAX_TYPE || indexesStale)
+    {
+        return -1;
+    }
+
+    // A type's tree only has bits for free slots of that type, so its runs
+    // never cross a slot of another type.
+    int tree = typeTree[type];
+    if (tree == NO_TREE)
+    {
+        return -1;
+    }
+
+    return tree == ALL_TYPES ? freeRuns.findRun(count) : typeRuns[tree].findRun(count);
+}
+
+int ParkingArea::getSlotCount() const
+{
+    return static_cast<int>(slots.size());
 }
 
-ParkingSlot* ParkingArea::getFirstAvailableSlot()
+int ParkingArea::getSlotId(int index) const
 {
-    for (auto& slot : slots)
+    return slotIds.empty() ? firstSlotId + index : slotIds[index];
+}
+
+const std::vector<PackedSlot>& ParkingArea::getPackedSlots() const
+{
+    return slots;
+}
+
+ParkingSlot ParkingArea::getSlot(int index) const
+{
+    ParkingSlot slot(getSlotId(index), zoneId);
+    slot.setIsAvailable(slots[index].isAvailable());
+    slot.setType(slots[index].getType());
+    return slot;
+}
+
+SlotRef ParkingArea::findSlot(int slotId)
+{
+    if (slotIds.empty())
     {
-        if (slot.getIsAvailable())
+        // Consecutive ids: the position is the id's offset.
+        long long index = static_cast<long long>(slotId) - firstSlotId;
+        if (index >= 0 && index < static_cast<long long>(slots.size()))
         {
-            return &slot;
+            return SlotRef(this, static_cast<int>(index));
         }
+        return SlotRef();
     }
 
-    return nullptr;
+    for (std::size_t i = 0; i < slotIds.size(); ++i)
+    {
+        if (slotIds[i] == slotId)
+        {
+            return SlotRef(this, static_cast<int>(i));
+        }
+    }
+
+    return SlotRef();
+}
+
+void ParkingArea::setPowerBudget(int watts)
+{
+    powerBudget = watts;
 }
 
+int ParkingArea::getPowerBudget() const
+{
+    return powerBudget;
+}
+
+int ParkingArea::getPowerReserved() const
+{
+    return powerReserved;
+}
+
+int ParkingArea::getPowerHeadroom() const
+{
+    return powerBudget > powerReserved ? powerBudget - powerReserved : 0;
+}
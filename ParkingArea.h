@@ -2,24 +2,137 @@
 #ifndef PARKING_AREA_H
 #define PARKING_AREA_H
 
+#include <array>
+#include <cstdint>
 #include <vector>
 
+#include "FreeRunTree.h"
 #include "ParkingSlot.h"
 
+class ParkingArea;
+
+// Mutable handle to one slot inside a ParkingArea, with the same accessors
+// as ParkingSlot. A default-constructed handle refers to no slot and tests
+// false. Invalidated when the area (or its zone) is moved or grows.
+class SlotRef
+{
+private:
+    ParkingArea* area;
+    int index;
+
+public:
+    SlotRef();
+    SlotRef(ParkingArea* area, int index);
+
+    explicit operator bool() const;
+
+    int getSlotId() const;
+    int getZoneId() const;
+
+    bool getIsAvailable() const;
+    void setIsAvailable(bool isAvailable);
+
+    // Sets this slot and the count - 1 slots after it in the same area.
+    void setRunAvailable(int count, bool isAvailable);
+
+    int getType() const;
+    void setType(int type);
+
+    // Charging power held against / returned to the owning area's budget.
+    void reservePower(int watts);
+    void releasePower(int watts);
+};
+
+// Slots are stored as one PackedSlot word each (4 bytes instead of a
+// 12-byte ParkingSlot). Slot ids are derived from position: slot i has id
+// firstSlotId + i. Areas given non-consecutive ids through addParkingSlot
+// fall back to storing the ids in a side table.
+//
+// Free slots are also indexed by FreeRunTrees, kept in step by
+// setAvailable(), so a run of k adjacent free slots is found in O(log n):
+// one tree over every slot, plus one per slot type when the area mixes
+// types (a uniform area answers type queries from the first). Each tree
+// costs about 1.4 bits per slot.
 class ParkingArea
 {
 private:
+    friend class SlotRef;
+
     int areaId;
-    std::vector<ParkingSlot> slots;
+    int zoneId;
+    int firstSlotId;
+    std::vector<PackedSlot> slots;
+
+    // Empty unless the ids are not consecutive; otherwise one id per slot.
+    std::vector<int> slotIds;
+
+    // Rebuilt on the next query after slots are added or retyped.
+    // typeTree[type] is an index into typeRuns, ALL_TYPES for freeRuns, or
+    // NO_TREE if the area has no slot of that type.
+    static constexpr std::int8_t ALL_TYPES = -1;
+    static constexpr std::int8_t NO_TREE = -2;
+    FreeRunTree freeRuns;
+    std::vector<FreeRunTree> typeRuns;
+    std::array<std::int8_t, PackedSlot::MAX_TYPE + 1> typeTree;
+    bool indexesStale;
+
+    // Charging feed shared by the area's bays, in watts (-1: none), and the
+    // part of it held by current allocations.
+    int powerBudget;
+    int powerReserved;
+
+    void setAvailable(int index, bool isAvailable);
+    void setType(int index, int type);
 
 public:
     ParkingArea(int areaId);
 
+    // An area of slotCount free slots of one type, numbered firstSlotId,
+    // firstSlotId + 1, ... Allocates the slot storage once and fills it in place.
+    ParkingArea(int areaId, int zoneId, int firstSlotId, int slotCount, int type = 0);
+
     int getAreaId() const;
+    int getZoneId() const;
 
     void addParkingSlot(const ParkingSlot& slot);
-    ParkingSlot* getFirstAvailableSlot();
+    SlotRef getFirstAvailableSlot();
+
+    // First slot of the leftmost run of count adjacent free slots (by
+    // position), or an empty handle if there is none.
+    SlotRef findFreeRun(int count);
+
+    // The same, but every slot of the run has this type. O(log n).
+    SlotRef findFreeRun(int count, int type);
+
+    // Some free slot of this type, or an empty handle. O(log n).
+    SlotRef findFreeOfType(int type);
+
+    // Position of the slot findFreeOfType / findFreeRun(count, type) would
+    // return, or -1, without touching the area: safe for concurrent
+    // readers, but only once the indexes are current (-1 otherwise).
+    int peekFreeOfType(int type) const;
+    int peekFreeRun(int count, int type) const;
+
+    // Builds the free-slot indexes now rather than on the next query.
+    void refreshIndexes();
+
+    // -1 (the default) for an area without a charging feed.
+    void setPowerBudget(int watts);
+    int getPowerBudget() const;
+    int getPowerReserved() const;
+
+    // Watts that can still be reserved; 0 for an area without a feed.
+    int getPowerHeadroom() const;
+
+    int getSlotCount() const;
+    int getSlotId(int index) const;
+    const std::vector<PackedSlot>& getPackedSlots() const;
+
+    // Copy of the slot at index, as a standalone value.
+    ParkingSlot getSlot(int index) const;
+
+    // Returns the slot with this id, or an empty handle if it is not in this area.
+    SlotRef findSlot(int slotId);
 };
 
 #endif  // PARKING_AREA_H
-
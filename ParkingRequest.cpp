@@ -12,7 +12,13 @@ ParkingRequest::ParkingRequest(int requestId,
       vehicleId(vehicleId),
       requestedZone(requestedZone),
       requestTime(requestTime),
-      currentState(initialState)
+      arrivalTime(-1),
+      currentState(initialState),
+      allocatedZoneId(-1),
+      allocatedSlotId(-1),
+      allocatedSlotCount(0),
+      allocatedSlotType(0),
+      chargeWatts(0)
 {
 }
 
@@ -36,16 +42,96 @@ int ParkingRequest::getRequestTime() const
     return requestTime;
 }
 
+int ParkingRequest::getArrivalTime() const
+{
+    return arrivalTime;
+}
+
+void ParkingRequest::setArrivalTime(int time)
+{
+    arrivalTime = time;
+}
+
 ParkingRequest::State ParkingRequest::getCurrentState() const
 {
     return currentState;
 }
 
+int ParkingRequest::getAllocatedZoneId() const
+{
+    return allocatedZoneId;
+}
+
+int ParkingRequest::getAllocatedSlotId() const
+{
+    return allocatedSlotId;
+}
+
+int ParkingRequest::getAllocatedSlotCount() const
+{
+    return allocatedSlotCount;
+}
+
+int ParkingRequest::getAllocatedSlotType() const
+{
+    return allocatedSlotType;
+}
+
+void ParkingRequest::setAllocation(int zoneId, int slotId, int slotCount, int slotType)
+{
+    allocatedZoneId = zoneId;
+    allocatedSlotId = slotId;
+    allocatedSlotCount = slotCount;
+    allocatedSlotType = slotType;
+}
+
+int ParkingRequest::getChargeWatts() const
+{
+    return chargeWatts;
+}
+
+void ParkingRequest::setChargeWatts(int watts)
+{
+    chargeWatts = watts;
+}
+
 void ParkingRequest::setCurrentState(State state)
 {
     currentState = state;
 }
 
+const char* ParkingRequest::stateToString(State state)
+{
+    switch (state)
+    {
+    case State::REQUESTED: return "REQUESTED";
+    case State::ALLOCATED: return "ALLOCATED";
+    case State::OCCUPIED: return "OCCUPIED";
+    case State::RELEASED: return "RELEASED";
+    case State::CANCELLED: return "CANCELLED";
+    }
+
+    return "UNKNOWN";
+}
+
+bool ParkingRequest::stateFromString(const std::string& name, State& state)
+{
+    static const State ALL[] = {
+        State::REQUESTED, State::ALLOCATED, State::OCCUPIED, State::RELEASED, State::CANCELLED
+    };
+
+    for (State candidate : ALL)
+    {
+        if (name == stateToString(candidate))
+        {
+            state = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
+
 bool ParkingRequest::changeState(State newState)
 {
     bool isValid = false;
@@ -20,8 +20,20 @@ private:
     std::string vehicleId;
     int requestedZone;
     int requestTime;
+    // When the vehicle parked (ALLOCATED -> OCCUPIED); -1 until then.
+    int arrivalTime;
     State currentState;
 
+    // Slot handed out by the allocator (-1 while unallocated).
+    int allocatedZoneId;
+    int allocatedSlotId;
+    // Adjacent slots held, starting at allocatedSlotId (positions in one area).
+    int allocatedSlotCount;
+    int allocatedSlotType;  // ParkingSlot::Type of the first slot
+
+    // Charging power reserved from the slot's area, in watts (0: none).
+    int chargeWatts;
+
 public:
     ParkingRequest(int requestId,
                    const std::string& vehicleId,
@@ -33,10 +45,27 @@ public:
     const std::string& getVehicleId() const;
     int getRequestedZone() const;
     int getRequestTime() const;
+    int getArrivalTime() const;
+    void setArrivalTime(int time);
     State getCurrentState() const;
 
+    int getAllocatedZoneId() const;
+    int getAllocatedSlotId() const;
+    int getAllocatedSlotCount() const;
+    int getAllocatedSlotType() const;
+    void setAllocation(int zoneId, int slotId, int slotCount = 1, int slotType = 0);
+
+    int getChargeWatts() const;
+    void setChargeWatts(int watts);
+
     bool changeState(State newState);
 
+    // Upper-case state name as used by the HTTP API, e.g. "ALLOCATED".
+    static const char* stateToString(State state);
+
+    // Inverse of stateToString; returns false for unknown names.
+    static bool stateFromString(const std::string& name, State& state);
+
     // Used by rollback mechanisms to restore a previous state directly.
     void setCurrentState(State state);
 };
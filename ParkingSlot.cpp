@@ -2,7 +2,7 @@
 #include "ParkingSlot.h"
 
 ParkingSlot::ParkingSlot(int slotId, int zoneId)
-    : slotId(slotId), zoneId(zoneId), isAvailable(true)
+    : slotId(slotId), zoneId(zoneId), isAvailable(true), type(0)
 {
 }
 
@@ -36,3 +36,42 @@ void ParkingSlot::setIsAvailable(bool isAvailable)
     this->isAvailable = isAvailable;
 }
 
+int ParkingSlot::getType() const
+{
+    return type;
+}
+
+void ParkingSlot::setType(int type)
+{
+    this->type = static_cast<std::uint8_t>(type);
+}
+
+const char* ParkingSlot::typeToString(Type type)
+{
+    switch (type)
+    {
+    case Type::STANDARD: return "STANDARD";
+    case Type::COMPACT: return "COMPACT";
+    case Type::EV: return "EV";
+    case Type::ACCESSIBLE: return "ACCESSIBLE";
+    case Type::MOTORCYCLE: return "MOTORCYCLE";
+    case Type::OVERSIZED: return "OVERSIZED";
+    }
+
+    return "UNKNOWN";
+}
+
+bool ParkingSlot::typeFromString(const std::string& name, Type& type)
+{
+    for (int i = 0; i < TYPE_COUNT; ++i)
+    {
+        Type candidate = static_cast<Type>(i);
+        if (name == typeToString(candidate))
+        {
+            type = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -2,12 +2,39 @@
 #ifndef PARKING_SLOT_H
 #define PARKING_SLOT_H
 
+#include <cstdint>
+#include <string>
+
+// A slot as a standalone value: used to describe slots going into an area
+// and to copy one out. Areas do not store these (see PackedSlot).
 class ParkingSlot
 {
+public:
+    // Bay classes kept in the type field. STANDARD is 0, so slots that were
+    // never given a type are standard bays.
+    enum class Type
+    {
+        STANDARD,
+        COMPACT,
+        EV,
+        ACCESSIBLE,
+        MOTORCYCLE,
+        OVERSIZED
+    };
+
+    static const int TYPE_COUNT = 6;
+
+    // Upper-case name as used by the HTTP API, e.g. "EV".
+    static const char* typeToString(Type type);
+
+    // Inverse of typeToString; returns false for unknown names.
+    static bool typeFromString(const std::string& name, Type& type);
+
 private:
     int slotId;
     int zoneId;
     bool isAvailable;
+    std::uint8_t type;
 
 public:
     ParkingSlot(int slotId, int zoneId);
@@ -20,6 +47,56 @@ public:
 
     bool getIsAvailable() const;
     void setIsAvailable(bool isAvailable);
+
+    int getType() const;
+    void setType(int type);
+};
+
+// How a ParkingArea stores each slot: one 32-bit word.
+//   bit 0      available
+//   bits 1-4   type (0..MAX_TYPE)
+//   bits 5-31  reserved, 0
+// The slot id is not stored: it is the area's first slot id plus the
+// slot's index. The zone id is the owning area's.
+class PackedSlot
+{
+private:
+    std::uint32_t bits;
+
+    static const std::uint32_t AVAILABLE_BIT = 1u;
+    static const int TYPE_SHIFT = 1;
+    static const std::uint32_t TYPE_MASK = 0xFu << TYPE_SHIFT;
+
+public:
+    static const int MAX_TYPE = 15;
+
+    PackedSlot(bool isAvailable, int type)
+        : bits((isAvailable ? AVAILABLE_BIT : 0u) |
+               ((static_cast<std::uint32_t>(type) << TYPE_SHIFT) & TYPE_MASK))
+    {
+    }
+
+    bool isAvailable() const
+    {
+        return (bits & AVAILABLE_BIT) != 0;
+    }
+
+    void setAvailable(bool isAvailable)
+    {
+        bits = isAvailable ? (bits | AVAILABLE_BIT) : (bits & ~AVAILABLE_BIT);
+    }
+
+    int getType() const
+    {
+        return static_cast<int>((bits & TYPE_MASK) >> TYPE_SHIFT);
+    }
+
+    void setType(int type)
+    {
+        bits = (bits & ~TYPE_MASK) | ((static_cast<std::uint32_t>(type) << TYPE_SHIFT) & TYPE_MASK);
+    }
 };
 
+static_assert(sizeof(PackedSlot) == 4, "PackedSlot must stay one 32-bit word");
+
 #endif  
@@ -0,0 +1,111 @@
+#include "ParkingSnapshot.h"
+
+#include <algorithm>
+
+ParkingSnapshot::ParkingSnapshot()
+    : version(0),
+      totalSlots(0),
+      occupiedSlots(0),
+      activeRequests(0),
+      requestCount(0)
+{
+}
+
+SlotLayout::SlotLayout()
+    : slotCount(0), firstSlotId(0)
+{
+}
+
+void SlotLayout::add(int slotId, int type)
+{
+    if (slotCount == 0)
+    {
+        firstSlotId = slotId;
+    }
+
+    Span* last = spans.empty() ? nullptr : &spans.back();
+    if (last != nullptr && last->type == type && last->firstSlotId + last->count == slotId)
+    {
+        last->count += 1;
+    }
+    else
+    {
+        spans.push_back(Span{ slotCount, slotId, 1, type });
+    }
+
+    // First id off the firstSlotId + position pattern: map every id.
+    if (irregular.empty() && slotId != firstSlotId + slotCount)
+    {
+        for (const Span& span : spans)
+        {
+            for (int i = 0; i < span.count && span.firstIndex + i < slotCount; ++i)
+            {
+                irregular.emplace(span.firstSlotId + i, span.firstIndex + i);
+            }
+        }
+    }
+    if (!irregular.empty())
+    {
+        irregular.emplace(slotId, slotCount);
+    }
+
+    slotCount += 1;
+}
+
+int SlotLayout::indexOf(int slotId) const
+{
+    if (!irregular.empty())
+    {
+        auto found = irregular.find(slotId);
+        return found != irregular.end() ? found->second : -1;
+    }
+
+    long long index = static_cast<long long>(slotId) - firstSlotId;
+    return index >= 0 && index < slotCount ? static_cast<int>(index) : -1;
+}
+
+const SlotLayout::Span& SlotLayout::spanAt(int index) const
+{
+    auto after = std::upper_bound(spans.begin(), spans.end(), index,
+        [](int i, const Span& span) { return i < span.firstIndex; });
+    return *(after - 1);
+}
+
+int SlotLayout::slotIdAt(int index) const
+{
+    const Span& span = spanAt(index);
+    return span.firstSlotId + (index - span.firstIndex);
+}
+
+int SlotLayout::typeAt(int index) const
+{
+    return spanAt(index).type;
+}
+
+const ZoneSnapshot* ParkingSnapshot::findZone(int zoneId) const
+{
+    int position = zonePosition(zoneId);
+    return position >= 0 ? zones[position].get() : nullptr;
+}
+
+int ParkingSnapshot::zonePosition(int zoneId) const
+{
+    if (!zonePositions)
+    {
+        return -1;
+    }
+
+    auto found = zonePositions->find(zoneId);
+    return found != zonePositions->end() ? static_cast<int>(found->second) : -1;
+}
+
+const ZonePrice* ParkingSnapshot::findPrice(int zoneId) const
+{
+    int position = zonePosition(zoneId);
+    return position >= 0 ? &prices[static_cast<std::size_t>(position)] : nullptr;
+}
+
+const RequestRecord& ParkingSnapshot::getRequest(int requestId) const
+{
+    return requests[static_cast<std::size_t>(requestId)];
+}
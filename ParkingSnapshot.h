@@ -0,0 +1,151 @@
+#ifndef PARKING_SNAPSHOT_H
+#define PARKING_SNAPSHOT_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "CowVector.h"
+#include "ParkingRequest.h"
+
+// Immutable, read-only views of ParkingSystem state.
+//
+// Writers never modify a published snapshot. Instead they copy the small
+// top-level ParkingSnapshot, replace only the zone they touched and the
+// CowVector leaves under it (copy-on-write), and atomically publish the
+// new pointer. Readers
+// grab the current pointer once and can then walk it for as long as they
+// like without locks and without ever seeing a half-applied change.
+
+// Ids and types of a zone's slots, by position (areas in order). A zone's
+// slots are fixed once it is added, so this is built once and shared by
+// every snapshot of the zone. Stored as spans of consecutive ids of one
+// type, i.e. a few per area rather than anything per slot.
+struct SlotLayout
+{
+    struct Span
+    {
+        int firstIndex;
+        int firstSlotId;
+        int count;
+        int type;  // ParkingSlot::Type
+    };
+
+    std::vector<Span> spans;  // by firstIndex
+    int slotCount;
+
+    // Ids are firstSlotId + position unless `irregular` maps them.
+    int firstSlotId;
+    std::unordered_map<int, int> irregular;
+
+    SlotLayout();
+
+    // Appends the slot at the next position.
+    void add(int slotId, int type);
+
+    // Position of slotId, or -1 if the zone has no such slot. O(1).
+    int indexOf(int slotId) const;
+
+    // Span holding position index. O(log spans).
+    const Span& spanAt(int index) const;
+
+    int slotIdAt(int index) const;
+    int typeAt(int index) const;
+};
+
+// Occupancy of one zone. Everything but the holders lives in the shared
+// layout, so a snapshot costs 4 bytes per slot, and updating one slot
+// copies one 256-slot leaf of holders.
+struct ZoneSnapshot
+{
+    // Holder values other than request ids.
+    static constexpr int FREE = -1;
+    static constexpr int UNHELD = -2;  // taken, but by no request (e.g. when added)
+
+    int zoneId;
+    int capacity;
+    int occupiedSlots;
+    int freeStandard;  // free slots a standard car may use (STANDARD, OVERSIZED)
+
+    // Request holding each slot (by position), FREE or UNHELD.
+    CowVector<int> holders;
+
+    // Update that made this copy (see CowVector).
+    std::uint64_t epoch;
+
+    std::shared_ptr<const SlotLayout> layout;
+
+    int indexOf(int slotId) const
+    {
+        return layout->indexOf(slotId);
+    }
+
+    bool isOccupied(int index) const
+    {
+        return holders[index] != FREE;
+    }
+};
+
+// Current PriceCurve tier of a zone and its price, kept in step with its
+// occupiedSlots so a quote is a field read.
+struct ZonePrice
+{
+    int tier;
+    int cents;
+};
+
+// Copy of the fields of a ParkingRequest that the read endpoints expose.
+struct RequestRecord
+{
+    int requestId;
+    std::string vehicleId;
+    int requestedZone;
+    int allocatedZoneId;
+    int allocatedSlotId;
+    int slotCount;          // adjacent slots held from allocatedSlotId on
+    int slotType;           // ParkingSlot::Type of allocatedSlotId
+    int chargeWatts;        // charging power reserved, 0 for none
+    long long requestTime;  // seconds since epoch
+    ParkingRequest::State state;
+};
+
+struct ParkingSnapshot
+{
+    std::uint64_t version;
+
+    // Facility-wide counters.
+    int totalSlots;
+    int occupiedSlots;
+    int activeRequests;  // REQUESTED or ALLOCATED
+    int requestCount;
+
+    std::vector<std::shared_ptr<const ZoneSnapshot>> zones;
+
+    // zoneId -> position in zones. Replaced only when a zone is added.
+    std::shared_ptr<const std::unordered_map<int, std::size_t>> zonePositions;
+
+    // By zone position. Kept apart from the zones so a tier change or a
+    // new curve copies one price leaf, not the ZoneSnapshots.
+    CowVector<ZonePrice> prices;
+
+    // By request id; updating one request copies only its leaf.
+    CowVector<RequestRecord> requests;
+
+    ParkingSnapshot();
+
+    // Returns nullptr if no zone has this id. O(1).
+    const ZoneSnapshot* findZone(int zoneId) const;
+
+    // Position of zoneId in zones, or -1. O(1).
+    int zonePosition(int zoneId) const;
+
+    // Returns nullptr if no zone has this id. O(1).
+    const ZonePrice* findPrice(int zoneId) const;
+
+    // requestId must be in [0, requestCount).
+    const RequestRecord& getRequest(int requestId) const;
+};
+
+#endif  // PARKING_SNAPSHOT_H
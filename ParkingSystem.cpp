@@ -1,18 +1,340 @@
 #include "ParkingSystem.h"
 
 #include <algorithm>
+#include <ctime>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
 
 ParkingSystem::ParkingSystem()
+    : stateVersion(1), updateEpoch(0), batchThread(std::thread::id())
 {
+    auto initial = std::make_shared<ParkingSnapshot>();
+    initial->version = 1;
+    snapshot = initial;
 }
 
-void ParkingSystem::addZone(const Zone& zone)
+std::uint64_t ParkingSystem::getStateVersion() const
 {
-    zones.push_back(zone);
+    return stateVersion.load(std::memory_order_acquire);
 }
 
-int ParkingSystem::requestParking(const std::string& vehicleId, int requestedZoneId)
+std::shared_ptr<const ParkingSnapshot> ParkingSystem::getSnapshot() const
 {
+    return std::atomic_load(&snapshot);
+}
+
+bool ParkingSystem::inBatch() const
+{
+    // Only the batch thread itself can ever read its own id here.
+    return batchThread.load(std::memory_order_relaxed) == std::this_thread::get_id();
+}
+
+std::unique_lock<ReadWriteLock> ParkingSystem::lockForWrite()
+{
+    // Inside a batch, stateLock is already held for the whole batch.
+    if (inBatch())
+    {
+        return std::unique_lock<ReadWriteLock>();
+    }
+    return std::unique_lock<ReadWriteLock>(stateLock);
+}
+
+std::shared_ptr<ParkingSnapshot> ParkingSystem::beginUpdate()
+{
+    // A fresh epoch per private copy, so nothing a reader can reach is
+    // patched in place.
+
+    // Inside a batch every mutation patches the same private copy.
+    if (inBatch())
+    {
+        if (!batchSnapshot)
+        {
+            updateEpoch += 1;
+            batchSnapshot = std::make_shared<ParkingSnapshot>(*std::atomic_load(&snapshot));
+        }
+        return batchSnapshot;
+    }
+
+    updateEpoch += 1;
+
+    // Shallow copy: zone and request chunk pointers are shared with the
+    // previous snapshot until a mutator replaces them.
+    return std::make_shared<ParkingSnapshot>(*std::atomic_load(&snapshot));
+}
+
+void ParkingSystem::beginBatch()
+{
+    stateLock.lock();
+    batchThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+}
+
+void ParkingSystem::endBatch()
+{
+    batchThread.store(std::thread::id(), std::memory_order_relaxed);
+
+    if (batchSnapshot)
+    {
+        publish(std::move(batchSnapshot));  // leaves batchSnapshot empty
+    }
+
+    // Waiters may only be woken once the freed slots are visible.
+    for (int zoneId : batchWakeups)
+    {
+        wakeSlotWaiter(zoneId);
+    }
+    batchWakeups.clear();
+
+    stateLock.unlock();
+}
+
+std::shared_ptr<const ZoneSnapshot> ParkingSystem::buildZoneSnapshot(const Zone& zone) const
+{
+    auto view = std::make_shared<ZoneSnapshot>();
+    view->zoneId = zone.getZoneId();
+    view->epoch = updateEpoch;
+    view->capacity = 0;
+    view->occupiedSlots = 0;
+    view->freeStandard = 0;
+
+    auto layout = std::make_shared<SlotLayout>();
+    for (const auto& area : zone.getParkingAreas())
+    {
+        const std::vector<PackedSlot>& slots = area.getPackedSlots();
+        for (int i = 0; i < static_cast<int>(slots.size()); ++i)
+        {
+            bool isOccupied = !slots[i].isAvailable();
+            layout->add(area.getSlotId(i), slots[i].getType());
+            view->holders.push_back(isOccupied ? ZoneSnapshot::UNHELD : ZoneSnapshot::FREE, updateEpoch);
+            view->capacity += 1;
+            view->occupiedSlots += isOccupied ? 1 : 0;
+            if (!isOccupied && AllocationEngine::isCompatible(ParkingSlot::Type::STANDARD, slots[i].getType()))
+            {
+                view->freeStandard += 1;
+            }
+        }
+    }
+    layout->spans.shrink_to_fit();
+    view->layout = layout;
+
+    return view;
+}
+
+ZoneSnapshot& ParkingSystem::ownZone(ParkingSnapshot& next, std::size_t position)
+{
+    std::shared_ptr<const ZoneSnapshot>& zonePtr = next.zones[position];
+    if (zonePtr->epoch != updateEpoch)
+    {
+        auto copy = std::make_shared<ZoneSnapshot>(*zonePtr);
+        copy->epoch = updateEpoch;
+        zonePtr = copy;
+    }
+
+    // Made by this update, so only `next` can reach it.
+    return const_cast<ZoneSnapshot&>(*zonePtr);
+}
+
+int ParkingSystem::setSlotHolder(ParkingSnapshot& next, int zoneId, int slotId, int holderRequestId, int slotCount,
+                                 long long at)
+{
+    int position = next.zonePosition(zoneId);
+    if (position < 0)
+    {
+        return 0;
+    }
+
+    int first = next.zones[position]->indexOf(slotId);
+    if (first < 0)
+    {
+        return 0;
+    }
+
+    // A run is adjacent within one area, and areas are listed in order, so
+    // its slots are adjacent here too.
+    ZoneSnapshot& zone = ownZone(next, static_cast<std::size_t>(position));
+    int delta = 0;
+    int standardDelta = 0;  // of slots a standard car may use, for the facility tree
+    int end = std::min(first + slotCount, zone.capacity);
+    for (int i = first; i < end; ++i)
+    {
+        int change = (holderRequestId >= 0 ? 1 : 0) - (zone.isOccupied(i) ? 1 : 0);
+        delta += change;
+        if (change != 0 && AllocationEngine::isCompatible(ParkingSlot::Type::STANDARD, zone.layout->typeAt(i)))
+        {
+            standardDelta += change;
+        }
+        zone.holders.write(i, updateEpoch) = holderRequestId >= 0 ? holderRequestId : ZoneSnapshot::FREE;
+    }
+    zone.occupiedSlots += delta;
+    zone.freeStandard -= standardDelta;
+    next.occupiedSlots += delta;
+
+    // The price only changes when a breakpoint is crossed.
+    const ZonePrice& price = next.prices[static_cast<std::size_t>(position)];
+    int tier = pricing.tierFor(zone.occupiedSlots, zone.capacity, price.tier);
+    if (tier != price.tier)
+    {
+        next.prices.write(static_cast<std::size_t>(position), updateEpoch) = ZonePrice{ tier, pricing.priceCents(tier) };
+    }
+
+    facility.onZoneChange(zoneId, -delta, 0, -standardDelta);
+    if (delta != 0)
+    {
+        usage.onOccupancy(zoneId, at, zone.occupiedSlots);
+    }
+    return -standardDelta;
+}
+
+void ParkingSystem::recordRequest(ParkingSnapshot& next, const ParkingRequest& request)
+{
+    RequestRecord record;
+    record.requestId = request.getRequestId();
+    record.vehicleId = request.getVehicleId();
+    record.requestedZone = request.getRequestedZone();
+    record.allocatedZoneId = request.getAllocatedZoneId();
+    record.allocatedSlotId = request.getAllocatedSlotId();
+    record.slotCount = request.getAllocatedSlotCount();
+    record.slotType = request.getAllocatedSlotType();
+    record.chargeWatts = request.getChargeWatts();
+    record.requestTime = request.getRequestTime();
+    record.state = request.getCurrentState();
+
+    if (record.requestId < next.requestCount)
+    {
+        next.requests.write(record.requestId, updateEpoch) = std::move(record);
+    }
+    else
+    {
+        next.requests.push_back(record, updateEpoch);
+        next.requestCount += 1;
+    }
+}
+
+void ParkingSystem::publish(std::shared_ptr<ParkingSnapshot> next)
+{
+    if (inBatch())
+    {
+        return;  // published once by endBatch()
+    }
+
+    next->version = stateVersion.load(std::memory_order_relaxed) + 1;
+    std::uint64_t version = next->version;
+
+    std::atomic_store(&snapshot, std::shared_ptr<const ParkingSnapshot>(std::move(next)));
+
+    // Publish the version only after the snapshot it describes is visible.
+    stateVersion.store(version, std::memory_order_release);
+}
+
+SlotRef ParkingSystem::findAllocatedSlot(const ParkingRequest& request)
+{
+    for (auto& zone : zones)
+    {
+        if (zone.getZoneId() == request.getAllocatedZoneId())
+        {
+            return zone.findSlot(request.getAllocatedSlotId());
+        }
+    }
+
+    return SlotRef();
+}
+
+int ParkingSystem::freeAllocatedSlots(ParkingSnapshot& next, const ParkingRequest& request, long long at)
+{
+    SlotRef slot = findAllocatedSlot(request);
+    if (!slot)
+    {
+        return 0;
+    }
+
+    int count = request.getAllocatedSlotCount();
+    slot.setRunAvailable(count, true);
+    slot.releasePower(request.getChargeWatts());
+    return setSlotHolder(next, request.getAllocatedZoneId(), request.getAllocatedSlotId(), -1, count, at);
+}
+
+long long ParkingSystem::resolveTime(long long at)
+{
+    return at == CURRENT_TIME ? static_cast<long long>(std::time(nullptr)) : at;
+}
+
+void ParkingSystem::wakeSlotWaiter(int zoneId)
+{
+    if (inBatch())
+    {
+        batchWakeups.push_back(zoneId);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(waiterLock);
+    slotWaiters.wakeOne(zoneId);
+}
+
+std::uint64_t ParkingSystem::waitForSlot(int zoneId, SlotWaiters::Callback wake)
+{
+    std::lock_guard<std::mutex> lock(waiterLock);
+
+    const ZoneSnapshot* zone = getSnapshot()->findZone(zoneId);
+    if (zone != nullptr && zone->freeStandard > 0)
+    {
+        return 0;
+    }
+
+    return slotWaiters.add(zoneId, std::move(wake));
+}
+
+bool ParkingSystem::cancelWait(int zoneId, std::uint64_t token)
+{
+    std::lock_guard<std::mutex> lock(waiterLock);
+    return slotWaiters.remove(zoneId, token);
+}
+
+bool ParkingSystem::addZone(const Zone& zone, long long at)
+{
+    return emplaceZone(Zone(zone), at);
+}
+
+bool ParkingSystem::emplaceZone(Zone&& zone, long long at)
+{
+    std::unique_lock<ReadWriteLock> lock = lockForWrite();
+
+    // A second Zone with the same id would be allocated from while its
+    // holders are written to the first one's snapshot.
+    std::shared_ptr<const ParkingSnapshot> latest = inBatch() && batchSnapshot ? batchSnapshot : getSnapshot();
+    if (latest->zonePosition(zone.getZoneId()) >= 0)
+    {
+        return false;
+    }
+
+    zones.push_back(std::move(zone));
+    zones.back().refreshIndexes();
+
+    auto next = beginUpdate();
+    auto view = buildZoneSnapshot(zones.back());
+    next->totalSlots += view->capacity;
+    next->occupiedSlots += view->occupiedSlots;
+    next->zones.push_back(view);
+    int tier = pricing.tierFor(view->occupiedSlots, view->capacity, 0);
+    next->prices.push_back(ZonePrice{ tier, pricing.priceCents(tier) }, updateEpoch);
+    requestStats.addZone(view->zoneId);
+    usage.onOccupancy(view->zoneId, resolveTime(at), view->occupiedSlots);
+
+    auto positions = next->zonePositions
+        ? std::make_shared<std::unordered_map<int, std::size_t>>(*next->zonePositions)
+        : std::make_shared<std::unordered_map<int, std::size_t>>();
+    positions->emplace(view->zoneId, next->zones.size() - 1);
+    next->zonePositions = positions;
+
+    publish(next);
+    return true;
+}
+
+int ParkingSystem::requestParking(const std::string& vehicleId, int requestedZoneId, int slotCount,
+                                  int vehicleClass, int chargeWatts, long long at)
+{
+    std::unique_lock<ReadWriteLock> lock = lockForWrite();
+    at = resolveTime(at);
+
     // Ensure the vehicle exists or create it
     auto vehicleIt = std::find_if(
         vehicles.begin(), vehicles.end(),
@@ -29,47 +351,86 @@ int ParkingSystem::requestParking(const std::string& vehicleId, int requestedZon
     ParkingRequest request(requestId,
                            vehicleId,
                            requestedZoneId,
-                           /*requestTime*/ 0,
+                           static_cast<int>(at),
                            ParkingRequest::State::REQUESTED);
 
+    // Demand counts whether or not a slot is found.
+    usage.onRequest(requestedZoneId, request.getRequestTime());
+
     // Try to allocate a slot
     if (zones.empty())
     {
+        requestStats.onRequest(requestedZoneId, -1);
         return -1;
     }
 
-    ParkingSlot* slot = allocationEngine.allocateSlot(requestedZoneId,
-                                                      zones.data(),
-                                                      static_cast<int>(zones.size()));
+    // Charging needs an EV bay, and the headroom check below only holds
+    // because nothing else can reserve power until this call returns.
+    if (chargeWatts < 0 ||
+        (chargeWatts > 0 && vehicleClass != static_cast<int>(ParkingSlot::Type::EV)))
+    {
+        requestStats.onRequest(requestedZoneId, -1);
+        return -1;
+    }
+
+    SlotRef slot;
+    if (vehicleClass == ANY_VEHICLE_CLASS)
+    {
+        vehicleClass = static_cast<int>(ParkingSlot::Type::STANDARD);
+    }
+
+    bool knownClass = vehicleClass >= 0 && vehicleClass < ParkingSlot::TYPE_COUNT;
+    if (knownClass && chargeWatts > 0 && slotCount == 1)
+    {
+        slot = allocationEngine.allocateForClass(requestedZoneId,
+                                                 zones.data(),
+                                                 static_cast<int>(zones.size()),
+                                                 static_cast<ParkingSlot::Type>(vehicleClass),
+                                                 chargeWatts);
+    }
+    else if (knownClass && chargeWatts == 0)
+    {
+        slot = allocationEngine.allocateRun(requestedZoneId,
+                                            zones.data(),
+                                            static_cast<int>(zones.size()),
+                                            slotCount,
+                                            static_cast<ParkingSlot::Type>(vehicleClass));
+    }
 
-    if (slot == nullptr)
+    if (!slot)
     {
         // No slot available, do not store the request
+        requestStats.onRequest(requestedZoneId, -1);
         return -1;
     }
 
-    // Record previous states for rollback
-    bool prevAvailability = slot->getIsAvailable();
-    ParkingRequest::State prevState = request.getCurrentState();
-
     // Update current state and slot
-    slot->setIsAvailable(false);
+    slot.setRunAvailable(slotCount, false);
     request.changeState(ParkingRequest::State::ALLOCATED);
+    request.setAllocation(slot.getZoneId(), slot.getSlotId(), slotCount, slot.getType());
+    request.setChargeWatts(chargeWatts);
+    slot.reservePower(chargeWatts);
 
     // Persist the request
     requests.push_back(request);
 
-    // Record allocation in rollback manager
-    rollbackManager.recordAllocation(slot,
-                                     prevAvailability,
-                                     &requests.back(),
-                                     prevState);
+    requestIndex.add(requests.back());
+    requestStats.onRequest(requestedZoneId, slot.getZoneId());
+
+    auto next = beginUpdate();
+    setSlotHolder(*next, slot.getZoneId(), slot.getSlotId(), requestId, slotCount, at);
+    recordRequest(*next, requests.back());
+    next->activeRequests += 1;
+    publish(next);
 
     return requestId;
 }
 
-bool ParkingSystem::cancelRequest(int requestId)
+bool ParkingSystem::cancelRequest(int requestId, long long at)
 {
+    std::unique_lock<ReadWriteLock> lock = lockForWrite();
+    at = resolveTime(at);
+
     if (requestId < 0 || requestId >= static_cast<int>(requests.size()))
     {
         return false;
@@ -91,14 +452,104 @@ bool ParkingSystem::cancelRequest(int requestId)
         return false;
     }
 
-    // Roll back the last operation affecting this request/slot
-    rollbackManager.rollback(1);
+    requestIndex.onStateChange(request, current);
+    requestStats.onCancel(request.getRequestedZone());
+
+    auto next = beginUpdate();
+
+    // Free the slots this request holds.
+    int freed = freeAllocatedSlots(*next, request, at);
+
+    if (current == ParkingRequest::State::REQUESTED ||
+        current == ParkingRequest::State::ALLOCATED)
+    {
+        next->activeRequests -= 1;
+    }
+
+    recordRequest(*next, request);
+    publish(next);
+
+    for (int i = 0; i < freed; ++i)
+    {
+        wakeSlotWaiter(request.getAllocatedZoneId());
+    }
+
+    return true;
+}
+
+bool ParkingSystem::occupySlot(int requestId, long long at)
+{
+    std::unique_lock<ReadWriteLock> lock = lockForWrite();
+    at = resolveTime(at);
+
+    if (requestId < 0 || requestId >= static_cast<int>(requests.size()))
+    {
+        return false;
+    }
+
+    ParkingRequest& request = requests[requestId];
+
+    ParkingRequest::State state = request.getCurrentState();
+    if (state != ParkingRequest::State::ALLOCATED)
+    {
+        return false;
+    }
+
+    if (!request.changeState(ParkingRequest::State::OCCUPIED))
+    {
+        return false;
+    }
+
+    request.setArrivalTime(static_cast<int>(at));
+    requestIndex.onStateChange(request, state);
+
+    auto next = beginUpdate();
+    next->activeRequests -= 1;
+    recordRequest(*next, request);
+    publish(next);
 
     return true;
 }
 
-bool ParkingSystem::releaseSlot(int requestId)
+int ParkingSystem::applySensorReading(int zoneId, int slotId, bool occupied, long long at)
 {
+    int holder = -1;
+    {
+        std::unique_lock<ReadWriteLock> lock = lockForWrite();
+
+        // Inside a batch that has already mutated, the latest state is the
+        // unpublished batchSnapshot.
+        std::shared_ptr<const ParkingSnapshot> view = inBatch() && batchSnapshot ? batchSnapshot : getSnapshot();
+        const ZoneSnapshot* zone = view->findZone(zoneId);
+        if (zone == nullptr)
+        {
+            return -1;
+        }
+
+        int index = zone->indexOf(slotId);
+        if (index >= 0)
+        {
+            holder = zone->holders[index];
+        }
+
+        ParkingRequest::State wanted = occupied ? ParkingRequest::State::ALLOCATED
+                                                : ParkingRequest::State::OCCUPIED;
+        if (holder < 0 || requests[holder].getCurrentState() != wanted)
+        {
+            return -1;
+        }
+    }
+
+    // Both re-check the state, so a change in between is harmless.
+    bool moved = occupied ? occupySlot(holder, at) : releaseSlot(holder, at);
+    return moved ? holder : -1;
+}
+
+bool ParkingSystem::releaseSlot(int requestId, long long at)
+{
+    std::unique_lock<ReadWriteLock> lock = lockForWrite();
+    at = resolveTime(at);
+
     if (requestId < 0 || requestId >= static_cast<int>(requests.size()))
     {
         return false;
@@ -120,8 +571,199 @@ bool ParkingSystem::releaseSlot(int requestId)
         return false;
     }
 
-    // Roll back one allocation to free the slot and restore previous state
-    rollbackManager.rollback(1);
+    requestIndex.onStateChange(request, state);
+
+    // A stay is the time actually parked; a vehicle that never arrived
+    // has none.
+    if (state == ParkingRequest::State::OCCUPIED)
+    {
+        requestStats.onRelease(request.getAllocatedZoneId(),
+                               at - request.getArrivalTime());
+    }
+
+    auto next = beginUpdate();
+
+    // Free the slots this request holds
+    int freed = freeAllocatedSlots(*next, request, at);
+
+    if (state == ParkingRequest::State::ALLOCATED)
+    {
+        next->activeRequests -= 1;
+    }
+
+    recordRequest(*next, request);
+    publish(next);
+
+    for (int i = 0; i < freed; ++i)
+    {
+        wakeSlotWaiter(request.getAllocatedZoneId());
+    }
+
+    return true;
+}
+
+ParkingSystem::RequestQueryResult ParkingSystem::queryRequests(const RequestQuery& query) const
+{
+    RequestQueryResult result;
+
+    std::shared_lock<ReadWriteLock> lock(stateLock);
+    result.snapshot = getSnapshot();
+    result.nextCursor = requestIndex.query(query, *result.snapshot, result.requestIds);
+
+    return result;
+}
+
+int ParkingSystem::addFacilityNode(int parentId, const std::string& kind, const std::string& name)
+{
+    std::unique_lock<ReadWriteLock> lock = lockForWrite();
+    return facility.addNode(parentId, kind, name);
+}
+
+int ParkingSystem::attachZoneToFacility(int parentId, int zoneId)
+{
+    std::unique_lock<ReadWriteLock> lock = lockForWrite();
+
+    std::shared_ptr<const ParkingSnapshot> view = inBatch() && batchSnapshot ? batchSnapshot : getSnapshot();
+    const ZoneSnapshot* zone = view->findZone(zoneId);
+    if (zone == nullptr)
+    {
+        return -1;
+    }
+
+    return facility.attachZone(parentId, zoneId, "Zone " + std::to_string(zoneId),
+                               zone->capacity - zone->occupiedSlots, zone->capacity, zone->freeStandard);
+}
+
+bool ParkingSystem::getFacilityNode(int nodeId, FacilityTree::Summary& node,
+                                    std::vector<FacilityTree::Summary>& children) const
+{
+    std::shared_lock<ReadWriteLock> lock(stateLock);
+
+    if (!facility.contains(nodeId))
+    {
+        return false;
+    }
+
+    node = facility.summarize(nodeId);
+    children.clear();
+    for (int childId : facility.getChildren(nodeId))
+    {
+        children.push_back(facility.summarize(childId));
+    }
+    return true;
+}
+
+bool ParkingSystem::findFreeSlotUnder(int nodeId, int& zoneId, int& slotId) const
+{
+    std::shared_lock<ReadWriteLock> lock(stateLock);
+
+    zoneId = facility.findFreeZone(nodeId);
+    if (zoneId < 0)
+    {
+        return false;
+    }
+
+    // No writer can run while we hold the lock, so the model agrees with
+    // the tree, and the published snapshot lists zones in model order.
+    int position = getSnapshot()->zonePosition(zoneId);
+    if (position < 0)
+    {
+        return false;
+    }
+
+    slotId = AllocationEngine::peekForClass(zones[position], ParkingSlot::Type::STANDARD);
+    return slotId >= 0;
+}
+
+bool ParkingSystem::setPriceCurve(int basePriceCents, const std::vector<PriceCurve::Tier>& tiers)
+{
+    std::unique_lock<ReadWriteLock> lock = lockForWrite();
+
+    if (!pricing.set(basePriceCents, tiers))
+    {
+        return false;
+    }
 
+    auto next = beginUpdate();
+    for (std::size_t position = 0; position < next->zones.size(); ++position)
+    {
+        const ZoneSnapshot& zone = *next->zones[position];
+        int tier = pricing.tierFor(zone.occupiedSlots, zone.capacity, next->prices[position].tier);
+        ZonePrice price{ tier, pricing.priceCents(tier) };
+        if (price.tier != next->prices[position].tier || price.cents != next->prices[position].cents)
+        {
+            next->prices.write(position, updateEpoch) = price;
+        }
+    }
+    publish(next);
     return true;
-}
\ No newline at end of file
+}
+
+PriceCurve ParkingSystem::getPriceCurve() const
+{
+    std::shared_lock<ReadWriteLock> lock(stateLock);
+    return pricing;
+}
+
+bool ParkingSystem::getUsage(int zoneId, UsageHistory::Resolution resolution, int count,
+                             std::vector<UsageSeries::Bucket>& buckets) const
+{
+    std::shared_lock<ReadWriteLock> lock(stateLock);
+    return usage.read(zoneId, resolution, static_cast<long long>(std::time(nullptr)), count, buckets);
+}
+
+RequestStats::Counters ParkingSystem::getRequestStats() const
+{
+    std::shared_lock<ReadWriteLock> lock(stateLock);
+    return requestStats.getTotal();
+}
+
+void ParkingSystem::getZoneRequestStats(std::vector<ZoneRequestStats>& out) const
+{
+    std::shared_lock<ReadWriteLock> lock(stateLock);
+
+    // One map lookup per zone.
+    out.clear();
+    for (const auto& zone : getSnapshot()->zones)
+    {
+        ZoneRequestStats stats;
+        stats.zoneId = zone->zoneId;
+        stats.counters = requestStats.getZone(zone->zoneId);
+        out.push_back(stats);
+    }
+}
+
+TDigest ParkingSystem::getStayDigest(const std::vector<int>& zoneIds) const
+{
+    std::shared_lock<ReadWriteLock> lock(stateLock);
+
+    TDigest merged;
+    requestStats.mergeStays(zoneIds, merged);
+    return merged;
+}
+
+bool ParkingSystem::getZonePower(int zoneId, std::vector<AreaPower>& areas) const
+{
+    std::shared_lock<ReadWriteLock> lock(stateLock);
+
+    for (const auto& zone : zones)
+    {
+        if (zone.getZoneId() != zoneId)
+        {
+            continue;
+        }
+
+        areas.clear();
+        for (const auto& area : zone.getParkingAreas())
+        {
+            AreaPower power;
+            power.areaId = area.getAreaId();
+            power.budgetWatts = area.getPowerBudget();
+            power.reservedWatts = area.getPowerReserved();
+            areas.push_back(power);
+        }
+        return true;
+    }
+
+    return false;
+}
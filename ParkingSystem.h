@@ -5,34 +5,247 @@
 #ifndef PARKING_SYSTEM_H
 #define PARKING_SYSTEM_H
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "AllocationEngine.h"
-#include "RollBackManager.h"
+#include "FacilityTree.h"
+#include "PriceCurve.h"
 #include "ParkingRequest.h"
+#include "ParkingSnapshot.h"
+#include "ReadWriteLock.h"
+#include "RequestIndex.h"
+#include "RequestStats.h"
+#include "SlotWaiters.h"
+#include "UsageHistory.h"
 #include "Vehicle.h"
 #include "Zone.h"
 
+// Thread safety: all public members may be called concurrently (e.g. from
+// Crow's worker threads). Mutators are serialized; snapshot readers never
+// wait for them.
 class ParkingSystem {
 private:
     std::vector<Zone> zones;
     std::vector<Vehicle> vehicles;
     std::vector<ParkingRequest> requests;
     AllocationEngine allocationEngine;
-    RollbackManager rollbackManager;
+
+    // Bumped after every successful mutation so readers can tell whether
+    // anything changed without walking the model.
+    std::atomic<std::uint64_t> stateVersion;
+
+    // Latest published read view. Only ever replaced (std::atomic_store),
+    // never modified in place, so readers need no lock.
+    std::shared_ptr<const ParkingSnapshot> snapshot;
+
+    // Copy-on-write helpers used by the mutators:
+    // beginUpdate() -> patch zones/requests -> publish().
+    std::shared_ptr<ParkingSnapshot> beginUpdate();
+    std::shared_ptr<const ZoneSnapshot> buildZoneSnapshot(const Zone& zone) const;
+    // next's zone at position, copied unless this update already did.
+    ZoneSnapshot& ownZone(ParkingSnapshot& next, std::size_t position);
+    // Sets the holder of slotId and of the slotCount - 1 slots after it.
+    // Returns the change in the zone's freeStandard.
+    int setSlotHolder(ParkingSnapshot& next, int zoneId, int slotId, int holderRequestId, int slotCount,
+                       long long at);
+    void recordRequest(ParkingSnapshot& next, const ParkingRequest& request);
+
+    // CowVector epoch of the copy beginUpdate() last handed out (one per
+    // batch); zones and leaves tagged with it are patched in place.
+    std::uint64_t updateEpoch;
+    void publish(std::shared_ptr<ParkingSnapshot> next);
+
+    // Filter indexes, updated together with publishing the snapshot so a
+    // query always sees an index and snapshot that agree with each other.
+    RequestIndex requestIndex;
+
+    // Campus / building / level aggregates; kept current by setSlotHolder.
+    FacilityTree facility;
+
+    // Zone prices; a zone's snapshot price is re-derived by setSlotHolder.
+    PriceCurve pricing;
+
+    // Per-zone occupancy / request-rate buckets; fed by setSlotHolder and
+    // requestParking.
+    UsageHistory usage;
+
+    // Success / fallback / cancellation / stay counters; fed by
+    // requestParking, cancelRequest and releaseSlot (stays run from the
+    // occupySlot arrival, so only OCCUPIED releases count).
+    RequestStats requestStats;
+
+    // Every mutator holds this exclusively for its whole duration, so writes
+    // are serialized. Snapshot readers never touch it; index queries take
+    // it shared.
+    mutable ReadWriteLock stateLock;
+
+    // Batch state (see beginBatch). Mutators called on batchThread skip
+    // taking stateLock, patch batchSnapshot and defer publish and wakeups.
+    std::atomic<std::thread::id> batchThread;
+    std::shared_ptr<ParkingSnapshot> batchSnapshot;
+    std::vector<int> batchWakeups;
+
+    bool inBatch() const;
+    std::unique_lock<ReadWriteLock> lockForWrite();
+
+    // Clients parked until a slot frees up in a given zone. Registration
+    // checks the published snapshot under waiterLock, and freeing a slot
+    // publishes before it wakes under the same lock, so no wakeup is lost.
+    SlotWaiters slotWaiters;
+    std::mutex waiterLock;
+
+    // Slot currently recorded as allocated to this request, or an empty handle.
+    SlotRef findAllocatedSlot(const ParkingRequest& request);
+
+    // Called after publishing a snapshot in which a slot of zoneId is free.
+    void wakeSlotWaiter(int zoneId);
+
+    // Marks the request's slots free in the model and in next; returns how
+    // many of them a standard car may use (the ones a waiter can take).
+    int freeAllocatedSlots(ParkingSnapshot& next, const ParkingRequest& request, long long at);
+
+    static long long resolveTime(long long at);
 
 public:
     ParkingSystem();
 
-    void addZone(const Zone& zone);
+    // Mutators take `at`, the time the change happened (seconds since
+    // epoch). CommandQueue passes each command's submission time, so a
+    // command is not stamped with when the writer got to it;
+    // CURRENT_TIME reads the clock.
+    static const long long CURRENT_TIME = -1;
+
+    // False (and nothing changes) if a zone with that id already exists.
+    bool addZone(const Zone& zone, long long at = CURRENT_TIME);
+
+    // Takes ownership of a (possibly very large) zone without copying its
+    // areas or slots. False if the zone id is taken.
+    bool emplaceZone(Zone&& zone, long long at = CURRENT_TIME);
+
+    // requestParking's vehicleClass when none is given: a standard car,
+    // i.e. ParkingSlot::Type::STANDARD.
+    static const int ANY_VEHICLE_CLASS = -1;
 
     // Creates a request and allocates a slot immediately (if available).
-    // Returns requestId on success, or -1 on failure.
-    int requestParking(const std::string& vehicleId, int requestedZoneId);
+    // With slotCount > 1 the request takes that many adjacent slots of one
+    // area and type, all or none. The vehicleClass (a ParkingSlot::Type)
+    // restricts it to the slot types that class may use, so an untyped
+    // request never takes an EV or ACCESSIBLE bay.
+    // chargeWatts > 0 asks for one EV bay in an area whose power budget can
+    // still supply that rate; the power is reserved together with the slot
+    // and returned when the request ends. Returns requestId on success, or
+    // -1 on failure.
+    int requestParking(const std::string& vehicleId, int requestedZoneId, int slotCount = 1,
+                       int vehicleClass = ANY_VEHICLE_CLASS, int chargeWatts = 0,
+                       long long at = CURRENT_TIME);
+
+    bool cancelRequest(int requestId, long long at = CURRENT_TIME);
+    bool releaseSlot(int requestId, long long at = CURRENT_TIME);
+
+    // Marks an ALLOCATED request's vehicle as parked (ALLOCATED -> OCCUPIED)
+    // at time `at`, where its stay starts. The slot stays taken; returns
+    // false for any other state.
+    bool occupySlot(int requestId, long long at = CURRENT_TIME);
+
+    // A ground sensor saw slotId of zoneId become occupied / vacant. Moves
+    // the request holding the slot ALLOCATED -> OCCUPIED on arrival and
+    // OCCUPIED -> RELEASED on departure; anything else (no holder, car not
+    // yet arrived) is ignored. Returns the request id moved, or -1.
+    int applySensorReading(int zoneId, int slotId, bool occupied, long long at = CURRENT_TIME);
+
+    // Groups the mutations made by the calling thread until endBatch():
+    // stateLock is taken once, and they become visible together as one
+    // snapshot (one version bump). Other threads' mutators wait meanwhile.
+    void beginBatch();
+    void endBatch();
+
+    // Calls `wake` once, when a slot in zoneId that a standard car may use is
+    // freed, unless it is cancelled first. Returns 0 without registering if
+    // the zone already has such a slot free (freeStandard); otherwise a token for cancelWait(). Each freed slot wakes
+    // exactly one waiter (oldest first). `wake` runs on the thread that freed
+    // the slot with a lock held, so it must only hand off work (e.g. post).
+    std::uint64_t waitForSlot(int zoneId, SlotWaiters::Callback wake);
+
+    // Returns false if the waiter was already woken.
+    bool cancelWait(int zoneId, std::uint64_t token);
+
+    // Monotonically increasing; equal values mean identical observable state.
+    std::uint64_t getStateVersion() const;
+
+    // Immutable view of the current state (occupancy, requests, counters).
+    // Safe to call from any thread; never blocks writers.
+    std::shared_ptr<const ParkingSnapshot> getSnapshot() const;
+
+    struct RequestQueryResult
+    {
+        std::shared_ptr<const ParkingSnapshot> snapshot;
+        std::vector<int> requestIds;  // ascending, look up in `snapshot`
+        int nextCursor;               // -1 when there are no more results
+    };
+
+    // Index-backed request filtering (state / zone / vehicle / time range).
+    // Costs O(size of the most selective index) rather than O(all requests).
+    RequestQueryResult queryRequests(const RequestQuery& query) const;
+
+    // Facility hierarchy (see FacilityTree). parentId -1 creates a root.
+    // Returns the new node id, or -1 for an invalid parent.
+    int addFacilityNode(int parentId, const std::string& kind, const std::string& name);
+
+    // Hangs an existing zone under a facility node. Returns the zone's node
+    // id, or -1 if the node or zone is unknown or the zone is already placed.
+    int attachZoneToFacility(int parentId, int zoneId);
+
+    // Counts of nodeId and of its direct children; false if unknown.
+    bool getFacilityNode(int nodeId, FacilityTree::Summary& node,
+                         std::vector<FacilityTree::Summary>& children) const;
+
+    // Some free slot a standard car may use anywhere under nodeId (no EV
+    // or ACCESSIBLE bay), found in O(depth) plus one zone's free-slot
+    // trees. False if there is none below.
+    bool findFreeSlotUnder(int nodeId, int& zoneId, int& slotId) const;
+
+    // Replaces the price curve and re-prices every zone. Returns false for
+    // an invalid curve (see PriceCurve::set).
+    bool setPriceCurve(int basePriceCents, const std::vector<PriceCurve::Tier>& tiers);
+    PriceCurve getPriceCurve() const;
+
+    // The last `count` buckets of zoneId's usage at this resolution, oldest
+    // first. False if the zone is unknown.
+    bool getUsage(int zoneId, UsageHistory::Resolution resolution, int count,
+                  std::vector<UsageSeries::Bucket>& buckets) const;
+
+    // Facility-wide request outcome counters.
+    RequestStats::Counters getRequestStats() const;
+
+    struct ZoneRequestStats
+    {
+        int zoneId;
+        RequestStats::Counters counters;
+    };
+
+    // The counters of every zone, in zone order. O(zones).
+    void getZoneRequestStats(std::vector<ZoneRequestStats>& out) const;
+
+    // Stay durations (seconds) of zoneIds, or of every zone if empty, as
+    // one merged digest. Costs O(zones x digest size), not O(stays).
+    TDigest getStayDigest(const std::vector<int>& zoneIds) const;
+
+    struct AreaPower
+    {
+        int areaId;
+        int budgetWatts;    // -1 for an area without a charging feed
+        int reservedWatts;
+    };
 
-    bool cancelRequest(int requestId);
-    bool releaseSlot(int requestId);
+    // Charging budget and reservations of each area of zoneId; false if
+    // there is no such zone.
+    bool getZonePower(int zoneId, std::vector<AreaPower>& areas) const;
 };
 
 #endif  // PARKING_SYSTEM_H
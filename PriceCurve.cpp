@@ -0,0 +1,74 @@
+#include "PriceCurve.h"
+
+PriceCurve::PriceCurve()
+    : basePriceCents(300),
+      tiers{ { 0, 60 }, { 30, 100 }, { 70, 125 }, { 85, 150 }, { 95, 200 } }
+{
+}
+
+bool PriceCurve::set(int basePriceCents, const std::vector<Tier>& tiers)
+{
+    if (basePriceCents < 0 || tiers.empty() || tiers.front().minUtilizationPercent != 0)
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < tiers.size(); ++i)
+    {
+        if (tiers[i].multiplierPercent <= 0 || tiers[i].minUtilizationPercent > 100)
+        {
+            return false;
+        }
+        if (i > 0 && tiers[i].minUtilizationPercent <= tiers[i - 1].minUtilizationPercent)
+        {
+            return false;
+        }
+    }
+
+    this->basePriceCents = basePriceCents;
+    this->tiers = tiers;
+    return true;
+}
+
+int PriceCurve::getBasePriceCents() const
+{
+    return basePriceCents;
+}
+
+const std::vector<PriceCurve::Tier>& PriceCurve::getTiers() const
+{
+    return tiers;
+}
+
+bool PriceCurve::reaches(int occupied, int capacity, int tier) const
+{
+    // occupied / capacity >= min%, without rounding.
+    return static_cast<long long>(occupied) * 100 >=
+           static_cast<long long>(tiers[tier].minUtilizationPercent) * capacity;
+}
+
+int PriceCurve::tierFor(int occupied, int capacity, int hint) const
+{
+    if (capacity <= 0)
+    {
+        return 0;
+    }
+
+    int last = static_cast<int>(tiers.size()) - 1;
+    int tier = hint < 0 ? 0 : (hint > last ? last : hint);
+
+    while (tier > 0 && !reaches(occupied, capacity, tier))
+    {
+        --tier;
+    }
+    while (tier < last && reaches(occupied, capacity, tier + 1))
+    {
+        ++tier;
+    }
+    return tier;
+}
+
+int PriceCurve::priceCents(int tier) const
+{
+    return static_cast<int>(static_cast<long long>(basePriceCents) * tiers[tier].multiplierPercent / 100);
+}
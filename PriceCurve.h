@@ -0,0 +1,51 @@
+#ifndef PRICE_CURVE_H
+#define PRICE_CURVE_H
+
+#include <vector>
+
+// Utilization-driven price of one hour of parking, shared by all zones.
+//
+// The curve is a step function of utilization (occupied / capacity):
+// tier i applies from tiers[i].minUtilizationPercent up to the next tier's
+// threshold, and its price is basePriceCents * multiplierPercent / 100.
+// A zone's price therefore only changes when its utilization crosses a
+// breakpoint. A one-slot change rarely moves a zone more than one tier, so
+// tierFor() walks from the zone's previous tier: O(1) in practice, never
+// more than O(tiers).
+//
+// Not synchronized; ParkingSystem guards it with stateLock.
+class PriceCurve
+{
+public:
+    struct Tier
+    {
+        int minUtilizationPercent;
+        int multiplierPercent;
+    };
+
+private:
+    int basePriceCents;
+    std::vector<Tier> tiers;
+
+    bool reaches(int occupied, int capacity, int tier) const;
+
+public:
+    // 60% of base when nearly empty, up to 200% when nearly full.
+    PriceCurve();
+
+    // Tiers must start at 0%, have strictly increasing thresholds up to
+    // 100% and positive multipliers. Returns false (and changes nothing)
+    // otherwise.
+    bool set(int basePriceCents, const std::vector<Tier>& tiers);
+
+    int getBasePriceCents() const;
+    const std::vector<Tier>& getTiers() const;
+
+    // Tier for this occupancy, searched from `hint` (any valid tier, e.g.
+    // the zone's previous one). An empty zone is in tier 0.
+    int tierFor(int occupied, int capacity, int hint) const;
+
+    int priceCents(int tier) const;
+};
+
+#endif  // PRICE_CURVE_H
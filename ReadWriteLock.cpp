@@ -0,0 +1,65 @@
+#include "ReadWriteLock.h"
+
+#include <thread>
+
+namespace
+{
+    // Busy-wait a little (the other side is usually about to finish),
+    // then give the CPU away.
+    template <typename Done>
+    void spinUntil(Done done)
+    {
+        for (int spins = 0; !done(); ++spins)
+        {
+            if (spins >= 64)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    std::atomic<std::size_t> nextSlot(0);
+}
+
+ReadWriteLock::ReadWriteLock()
+    : writerActive(false), pendingReaders(0)
+{
+    for (ReaderSlot& slot : slots)
+    {
+        slot.count.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::size_t ReadWriteLock::slotIndex()
+{
+    // Threads are dealt slots round-robin once; with more threads than
+    // slots some share, which is still correct.
+    thread_local std::size_t index = nextSlot.fetch_add(1, std::memory_order_relaxed) % READER_SLOTS;
+    return index;
+}
+
+void ReadWriteLock::waitForWriter()
+{
+    spinUntil([this]() { return !writerActive.load(std::memory_order_acquire); });
+}
+
+void ReadWriteLock::lock()
+{
+    writers.lock();
+
+    // Readers the previous writer turned away go first.
+    spinUntil([this]() { return pendingReaders.load(std::memory_order_seq_cst) == 0; });
+
+    // Announce so no new reader gets in, then drain the ones inside.
+    writerActive.store(true, std::memory_order_seq_cst);
+    for (ReaderSlot& slot : slots)
+    {
+        spinUntil([&slot]() { return slot.count.load(std::memory_order_seq_cst) == 0; });
+    }
+}
+
+void ReadWriteLock::unlock()
+{
+    writerActive.store(false, std::memory_order_release);
+    writers.unlock();
+}
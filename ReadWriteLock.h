@@ -0,0 +1,87 @@
+#ifndef READ_WRITE_LOCK_H
+#define READ_WRITE_LOCK_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+// Reader-biased shared/exclusive lock for read-mostly state.
+//
+// Readers register in one of READER_SLOTS counters, each on its own cache
+// line and picked per thread, so concurrent readers do not bounce a shared
+// counter between cores. Entering is one increment of the thread's slot
+// plus a check that no writer is active (no mutex, no syscall).
+//
+// A writer announces itself, which turns new readers away, and then drains
+// every slot, i.e. it only waits for readers already inside. Readers it
+// turned away are counted as pending, and the next writer may not announce
+// until they have all got in. So readers are never starved by a stream of
+// back-to-back writers, and writers are never starved by a stream of
+// readers (neither glibc's std::shared_mutex policy guarantees both).
+//
+// Meets the Lockable / SharedLockable requirements, so std::unique_lock and
+// std::shared_lock work as usual. Waiting spins briefly and then yields,
+// which suits critical sections of microseconds, not I/O.
+class ReadWriteLock
+{
+public:
+    static const std::size_t READER_SLOTS = 64;
+
+private:
+    struct alignas(64) ReaderSlot
+    {
+        std::atomic<int> count;
+    };
+
+    ReaderSlot slots[READER_SLOTS];
+    std::atomic<bool> writerActive;
+    std::atomic<int> pendingReaders;  // turned away by the active writer
+    std::mutex writers;               // serializes writers among themselves
+
+    static std::size_t slotIndex();
+    void waitForWriter();
+
+public:
+    ReadWriteLock();
+
+    ReadWriteLock(const ReadWriteLock&) = delete;
+    ReadWriteLock& operator=(const ReadWriteLock&) = delete;
+
+    void lock_shared()
+    {
+        std::atomic<int>& slot = slots[slotIndex()].count;
+        bool pending = false;
+        for (;;)
+        {
+            slot.fetch_add(1, std::memory_order_seq_cst);
+            if (!writerActive.load(std::memory_order_seq_cst))
+            {
+                if (pending)
+                {
+                    pendingReaders.fetch_sub(1, std::memory_order_seq_cst);
+                }
+                return;
+            }
+
+            // A writer got there first: step aside, but hold the next
+            // writer back until we are in.
+            slot.fetch_sub(1, std::memory_order_seq_cst);
+            if (!pending)
+            {
+                pendingReaders.fetch_add(1, std::memory_order_seq_cst);
+                pending = true;
+            }
+            waitForWriter();
+        }
+    }
+
+    void unlock_shared()
+    {
+        slots[slotIndex()].count.fetch_sub(1, std::memory_order_release);
+    }
+
+    void lock();
+    void unlock();
+};
+
+#endif  // READ_WRITE_LOCK_H
@@ -0,0 +1,222 @@
+#include "RequestIndex.h"
+
+#include <algorithm>
+
+namespace
+{
+    const std::vector<int> EMPTY_LIST;
+    const std::set<int> EMPTY_SET;
+
+    bool matches(const RequestQuery& query, const RequestRecord& record)
+    {
+        if (query.hasState && record.state != query.state)
+        {
+            return false;
+        }
+        if (query.activeOnly &&
+            record.state != ParkingRequest::State::ALLOCATED &&
+            record.state != ParkingRequest::State::OCCUPIED)
+        {
+            return false;
+        }
+        if (query.zoneId >= 0 && record.allocatedZoneId != query.zoneId)
+        {
+            return false;
+        }
+        if (!query.vehicleId.empty() && record.vehicleId != query.vehicleId)
+        {
+            return false;
+        }
+        if (query.fromTime >= 0 && record.requestTime < query.fromTime)
+        {
+            return false;
+        }
+        if (query.toTime >= 0 && record.requestTime >= query.toTime)
+        {
+            return false;
+        }
+        return true;
+    }
+
+    // First request id whose requestTime is >= time. Requests are stored in
+    // arrival order, so request times are non-decreasing in id.
+    int lowerBoundByTime(const ParkingSnapshot& snapshot, long long time)
+    {
+        int lo = 0;
+        int hi = snapshot.requestCount;
+        while (lo < hi)
+        {
+            int mid = lo + (hi - lo) / 2;
+            if (snapshot.getRequest(mid).requestTime < time)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    // Walks sorted candidate ids below stopId, collecting matches until
+    // query.limit is reached. Returns the next unvisited id, or -1.
+    template <typename Iterator>
+    int collect(Iterator it, Iterator end, int stopId,
+                const RequestQuery& query, const ParkingSnapshot& snapshot,
+                std::vector<int>& ids)
+    {
+        int taken = 0;
+        for (; it != end && *it < stopId; ++it)
+        {
+            if (taken == query.limit)
+            {
+                return *it;
+            }
+            if (matches(query, snapshot.getRequest(*it)))
+            {
+                ids.push_back(*it);
+                ++taken;
+            }
+        }
+        return -1;
+    }
+}
+
+bool RequestIndex::isActive(ParkingRequest::State state)
+{
+    return state == ParkingRequest::State::ALLOCATED ||
+           state == ParkingRequest::State::OCCUPIED;
+}
+
+void RequestIndex::add(const ParkingRequest& request)
+{
+    int id = request.getRequestId();
+
+    byState[static_cast<int>(request.getCurrentState())].insert(id);
+    byVehicle[request.getVehicleId()].push_back(id);
+
+    if (request.getAllocatedZoneId() >= 0)
+    {
+        byZone[request.getAllocatedZoneId()].push_back(id);
+        if (isActive(request.getCurrentState()))
+        {
+            activeByZone[request.getAllocatedZoneId()].insert(id);
+        }
+    }
+}
+
+void RequestIndex::onStateChange(const ParkingRequest& request, ParkingRequest::State previous)
+{
+    int id = request.getRequestId();
+    ParkingRequest::State current = request.getCurrentState();
+
+    byState[static_cast<int>(previous)].erase(id);
+    byState[static_cast<int>(current)].insert(id);
+
+    int zoneId = request.getAllocatedZoneId();
+    if (zoneId >= 0 && isActive(previous) != isActive(current))
+    {
+        if (isActive(current))
+        {
+            activeByZone[zoneId].insert(id);
+        }
+        else
+        {
+            activeByZone[zoneId].erase(id);
+        }
+    }
+}
+
+int RequestIndex::query(const RequestQuery& query, const ParkingSnapshot& snapshot, std::vector<int>& ids) const
+{
+    // Narrow the id range first when a time window is given.
+    int firstId = std::max(query.cursor, 0);
+    int stopId = snapshot.requestCount;
+    if (query.fromTime >= 0)
+    {
+        firstId = std::max(firstId, lowerBoundByTime(snapshot, query.fromTime));
+    }
+    if (query.toTime >= 0)
+    {
+        stopId = std::min(stopId, lowerBoundByTime(snapshot, query.toTime));
+    }
+    if (firstId >= stopId || query.limit <= 0)
+    {
+        return -1;
+    }
+
+    // Pick the smallest applicable index as the candidate source.
+    const std::set<int>* bestSet = nullptr;
+    const std::vector<int>* bestList = nullptr;
+    std::size_t bestSize = static_cast<std::size_t>(-1);
+
+    if (query.hasState)
+    {
+        bestSet = &byState[static_cast<int>(query.state)];
+        bestSize = bestSet->size();
+    }
+    if (query.zoneId >= 0)
+    {
+        if (query.activeOnly)
+        {
+            auto it = activeByZone.find(query.zoneId);
+            const std::set<int>* set = (it == activeByZone.end()) ? &EMPTY_SET : &it->second;
+            if (set->size() < bestSize)
+            {
+                bestSet = set;
+                bestList = nullptr;
+                bestSize = set->size();
+            }
+        }
+        else
+        {
+            auto it = byZone.find(query.zoneId);
+            const std::vector<int>* list = (it == byZone.end()) ? &EMPTY_LIST : &it->second;
+            if (list->size() < bestSize)
+            {
+                bestList = list;
+                bestSet = nullptr;
+                bestSize = list->size();
+            }
+        }
+    }
+    if (!query.vehicleId.empty())
+    {
+        auto it = byVehicle.find(query.vehicleId);
+        const std::vector<int>* list = (it == byVehicle.end()) ? &EMPTY_LIST : &it->second;
+        if (list->size() < bestSize)
+        {
+            bestList = list;
+            bestSet = nullptr;
+            bestSize = list->size();
+        }
+    }
+
+    if (bestSet != nullptr)
+    {
+        return collect(bestSet->lower_bound(firstId), bestSet->end(), stopId, query, snapshot, ids);
+    }
+
+    if (bestList != nullptr)
+    {
+        auto begin = std::lower_bound(bestList->begin(), bestList->end(), firstId);
+        return collect(begin, bestList->end(), stopId, query, snapshot, ids);
+    }
+
+    // No membership filter: the id range itself is the candidate list.
+    int taken = 0;
+    for (int id = firstId; id < stopId; ++id)
+    {
+        if (taken == query.limit)
+        {
+            return id;
+        }
+        if (matches(query, snapshot.getRequest(id)))
+        {
+            ids.push_back(id);
+            ++taken;
+        }
+    }
+    return -1;
+}
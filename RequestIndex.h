@@ -0,0 +1,60 @@
+#ifndef REQUEST_INDEX_H
+#define REQUEST_INDEX_H
+
+#include <climits>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ParkingRequest.h"
+#include "ParkingSnapshot.h"
+
+// Filter for request listings. Unset fields match everything.
+struct RequestQuery
+{
+    bool hasState = false;
+    ParkingRequest::State state = ParkingRequest::State::REQUESTED;
+    bool activeOnly = false;      // ALLOCATED or OCCUPIED (i.e. holding a slot)
+    int zoneId = -1;              // allocated zone
+    std::string vehicleId;        // empty = any vehicle
+    long long fromTime = -1;      // requestTime >= fromTime
+    long long toTime = -1;        // requestTime < toTime
+    int cursor = 0;               // first request id to consider
+    int limit = INT_MAX;
+};
+
+// Membership indexes over parking requests, kept up to date by
+// ParkingSystem on every state transition:
+//   state   -> request ids
+//   zone    -> request ids (allocated zone), and the subset holding a slot
+//   vehicle -> request ids
+// A query walks only the smallest index that applies, so its cost is
+// proportional to that index (usually the result), not to all requests.
+class RequestIndex
+{
+private:
+    static const int STATE_COUNT = 5;
+
+    std::set<int> byState[STATE_COUNT];
+    std::unordered_map<int, std::vector<int>> byZone;
+    std::unordered_map<int, std::set<int>> activeByZone;
+    std::unordered_map<std::string, std::vector<int>> byVehicle;
+
+    static bool isActive(ParkingRequest::State state);
+
+public:
+    // Registers a newly stored request under its current state.
+    void add(const ParkingRequest& request);
+
+    // Moves a request from `previous` to its current state.
+    void onStateChange(const ParkingRequest& request, ParkingRequest::State previous);
+
+    // Appends matching request ids (ascending, at most query.limit) to ids.
+    // Records are checked against `snapshot`, which must be the snapshot
+    // published together with the index's current contents.
+    // Returns the cursor for the next page, or -1 if there is none.
+    int query(const RequestQuery& query, const ParkingSnapshot& snapshot, std::vector<int>& ids) const;
+};
+
+#endif  // REQUEST_INDEX_H
@@ -0,0 +1,127 @@
+#include "RequestStats.h"
+
+namespace
+{
+    int roundedPercent(long long numerator, long long denominator)
+    {
+        if (denominator <= 0)
+        {
+            return 0;
+        }
+        return static_cast<int>((numerator * 100 + denominator / 2) / denominator);
+    }
+}
+
+RequestStats::Counters::Counters()
+    : requests(0), allocated(0), fallbacks(0), cancelled(0), stays(0), staySeconds(0)
+{
+}
+
+int RequestStats::Counters::successPercent() const
+{
+    return roundedPercent(allocated, requests);
+}
+
+int RequestStats::Counters::fallbackPercent() const
+{
+    return roundedPercent(fallbacks, allocated);
+}
+
+int RequestStats::Counters::cancelPercent() const
+{
+    return roundedPercent(cancelled, allocated);
+}
+
+long long RequestStats::Counters::averageStaySeconds() const
+{
+    return stays > 0 ? staySeconds / stays : 0;
+}
+
+RequestStats::Counters* RequestStats::find(int zoneId)
+{
+    auto found = zones.find(zoneId);
+    return found == zones.end() ? nullptr : &found->second;
+}
+
+void RequestStats::addZone(int zoneId)
+{
+    zones.emplace(zoneId, Counters());
+    stayDigests.emplace(zoneId, TDigest());
+}
+
+void RequestStats::onRequest(int requestedZoneId, int allocatedZoneId)
+{
+    bool allocated = allocatedZoneId >= 0;
+    bool fallback = allocated && allocatedZoneId != requestedZoneId;
+
+    total.requests += 1;
+    total.allocated += allocated ? 1 : 0;
+    total.fallbacks += fallback ? 1 : 0;
+
+    // Requests naming a nonexistent zone only count facility-wide.
+    if (Counters* zone = find(requestedZoneId))
+    {
+        zone->requests += 1;
+        zone->allocated += allocated ? 1 : 0;
+        zone->fallbacks += fallback ? 1 : 0;
+    }
+}
+
+void RequestStats::onCancel(int requestedZoneId)
+{
+    total.cancelled += 1;
+    if (Counters* zone = find(requestedZoneId))
+    {
+        zone->cancelled += 1;
+    }
+}
+
+void RequestStats::onRelease(int allocatedZoneId, long long staySeconds)
+{
+    // A clock stepped back must not make the average negative.
+    if (staySeconds < 0)
+    {
+        staySeconds = 0;
+    }
+
+    total.stays += 1;
+    total.staySeconds += staySeconds;
+    if (Counters* zone = find(allocatedZoneId))
+    {
+        zone->stays += 1;
+        zone->staySeconds += staySeconds;
+        stayDigests[allocatedZoneId].add(static_cast<double>(staySeconds));
+    }
+}
+
+const RequestStats::Counters& RequestStats::getTotal() const
+{
+    return total;
+}
+
+RequestStats::Counters RequestStats::getZone(int zoneId) const
+{
+    auto found = zones.find(zoneId);
+    return found == zones.end() ? Counters() : found->second;
+}
+
+void RequestStats::mergeStays(const std::vector<int>& zoneIds, TDigest& into) const
+{
+    if (zoneIds.empty())
+    {
+        for (const auto& entry : stayDigests)
+        {
+            into.merge(entry.second);
+        }
+        return;
+    }
+
+    for (int zoneId : zoneIds)
+    {
+        auto found = stayDigests.find(zoneId);
+        if (found != stayDigests.end())
+        {
+            into.merge(found->second);
+        }
+    }
+}
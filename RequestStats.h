@@ -0,0 +1,67 @@
+#ifndef REQUEST_STATS_H
+#define REQUEST_STATS_H
+
+#include <unordered_map>
+#include <vector>
+
+#include "TDigest.h"
+
+// Running outcome counters of parking requests, facility-wide and per zone,
+// updated by ParkingSystem on every request transition. Reading any rate is
+// a few divisions; nothing ever rescans the request history.
+//
+// Demand outcomes (requests, allocations, fallbacks, cancellations) count
+// against the zone the driver asked for; stays count against the zone that
+// was actually used.
+//
+// Each zone also keeps a TDigest of its stay durations, for quantiles.
+//
+// Not synchronized; ParkingSystem guards it with stateLock.
+class RequestStats
+{
+public:
+    struct Counters
+    {
+        long long requests;     // requestParking calls
+        long long allocated;    // ... that got a slot
+        long long fallbacks;    // ... in a zone other than the one asked for
+        long long cancelled;    // allocated requests later cancelled
+        long long stays;        // occupied requests released
+        long long staySeconds;  // summed arrival-to-release time of those
+
+        Counters();
+
+        // Rounded percentages; 0 when there is nothing to divide by.
+        int successPercent() const;    // allocated / requests
+        int fallbackPercent() const;   // fallbacks / allocated
+        int cancelPercent() const;     // cancelled / allocated
+        long long averageStaySeconds() const;
+    };
+
+private:
+    Counters total;
+    std::unordered_map<int, Counters> zones;
+    std::unordered_map<int, TDigest> stayDigests;
+
+    // Per-zone counters, or nullptr for a zone never added.
+    Counters* find(int zoneId);
+
+public:
+    void addZone(int zoneId);
+
+    // A request for requestedZoneId; allocatedZoneId is -1 if it failed.
+    void onRequest(int requestedZoneId, int allocatedZoneId);
+    void onCancel(int requestedZoneId);
+    void onRelease(int allocatedZoneId, long long staySeconds);
+
+    const Counters& getTotal() const;
+
+    // Zeroed counters for a zone nothing was recorded for.
+    Counters getZone(int zoneId) const;
+
+    // Merges the stay-duration digests of zoneIds (every zone if empty)
+    // into `into`. Unknown zones are skipped.
+    void mergeStays(const std::vector<int>& zoneIds, TDigest& into) const;
+};
+
+#endif  // REQUEST_STATS_H
@@ -0,0 +1,118 @@
+#include "ResponseCache.h"
+
+#include <charconv>
+
+std::shared_ptr<const ResponseCache::Entry> ResponseCache::find(const std::string& key,
+                                                                std::uint64_t version) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = entries.find(key);
+    if (it == entries.end() || it->second->version != version)
+    {
+        return nullptr;
+    }
+
+    return it->second;
+}
+
+std::shared_ptr<const ResponseCache::Entry> ResponseCache::store(const std::string& key,
+                                                                 std::uint64_t version,
+                                                                 std::string body)
+{
+    auto entry = std::make_shared<Entry>();
+    entry->version = version;
+    entry->body = std::move(body);
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Never let a slow renderer overwrite a body built from newer state.
+    auto& slot = entries[key];
+    if (!slot || slot->version <= version)
+    {
+        slot = entry;
+    }
+
+    return entry;
+}
+
+const std::string* ResponseCache::Entry::compressed(HttpCompression::Encoding encoding) const
+{
+    if (encoding == HttpCompression::IDENTITY || body.size() < HttpCompression::MIN_BYTES)
+    {
+        return nullptr;
+    }
+
+    // Concurrent first requests compress once; the rest wait for the result.
+    std::once_flag& once = encoding == HttpCompression::GZIP ? gzipOnce : deflateOnce;
+    std::string& out = encoding == HttpCompression::GZIP ? gzipBody : deflateBody;
+    std::call_once(once, [&]()
+    {
+        HttpCompression::compress(body, encoding, out);
+    });
+
+    return out.empty() ? nullptr : &out;
+}
+
+std::string ResponseCache::makeETag(std::uint64_t version, std::string_view representation)
+{
+    char buf[24];
+    buf[0] = '"';
+    auto result = std::to_chars(buf + 1, buf + sizeof(buf), version);
+
+    std::string tag(buf, static_cast<std::size_t>(result.ptr - buf));
+    if (!representation.empty())
+    {
+        tag += '-';
+        tag += representation;
+    }
+    tag += '"';
+    return tag;
+}
+
+bool ResponseCache::etagMatches(std::string_view ifNoneMatch, std::uint64_t version,
+                                std::string_view representation)
+{
+    std::size_t i = 0;
+    const std::size_t n = ifNoneMatch.size();
+
+    while (i < n)
+    {
+        char c = ifNoneMatch[i];
+        if (c == '*')
+        {
+            return true;
+        }
+
+        if (c != '"')
+        {
+            ++i;
+            continue;
+        }
+
+        // Quoted entity tag: a version number, then "-<representation>"
+        // unless it names the plain body.
+        std::size_t close = ifNoneMatch.find('"', i + 1);
+        if (close == std::string_view::npos)
+        {
+            return false;
+        }
+
+        std::uint64_t tagged = 0;
+        const char* first = ifNoneMatch.data() + i + 1;
+        const char* last = ifNoneMatch.data() + close;
+        auto result = std::from_chars(first, last, tagged);
+        std::string_view rest(result.ptr, static_cast<std::size_t>(last - result.ptr));
+        bool sameForm = representation.empty()
+            ? rest.empty()
+            : rest.size() == representation.size() + 1 && rest[0] == '-' && rest.substr(1) == representation;
+        if (result.ec == std::errc() && tagged == version && sameForm)
+        {
+            return true;
+        }
+
+        i = close + 1;
+    }
+
+    return false;
+}
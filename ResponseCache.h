@@ -0,0 +1,63 @@
+#ifndef RESPONSE_CACHE_H
+#define RESPONSE_CACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "HttpCompression.h"
+
+// Caches serialized read-endpoint bodies keyed by endpoint, tagged with the
+// ParkingSystem state version they were built from. A lookup at the current
+// version is a hash probe plus one integer compare; a stale entry is simply
+// replaced the next time the endpoint is rendered. Compressed forms of a
+// body are built on first use and kept with it, so a popular endpoint is
+// compressed once per state change rather than once per request.
+class ResponseCache
+{
+public:
+    struct Entry
+    {
+        std::uint64_t version;
+        std::string body;
+
+        // Body in the given Content-Encoding, or nullptr when it should be
+        // sent uncompressed (identity, too small, or zlib failed).
+        const std::string* compressed(HttpCompression::Encoding encoding) const;
+
+        mutable std::once_flag gzipOnce;
+        mutable std::once_flag deflateOnce;
+        mutable std::string gzipBody;
+        mutable std::string deflateBody;
+    };
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<const Entry>> entries;
+
+public:
+    // Returns the entry for key if it was built at exactly this version,
+    // otherwise nullptr.
+    std::shared_ptr<const Entry> find(const std::string& key, std::uint64_t version) const;
+
+    // Stores (or replaces) the body for key and returns the new entry.
+    std::shared_ptr<const Entry> store(const std::string& key,
+                                       std::uint64_t version,
+                                       std::string body);
+
+    // Strong ETag for one representation of a state version: "\"42\"" for
+    // the plain body, "\"42-<representation>\"" for any other form of it
+    // (e.g. a content coding). Representations of one version must not
+    // share a strong tag.
+    static std::string makeETag(std::uint64_t version, std::string_view representation = {});
+
+    // True if an If-None-Match header value names that representation of
+    // this version (handles lists, weak validators and "*").
+    static bool etagMatches(std::string_view ifNoneMatch, std::uint64_t version,
+                            std::string_view representation = {});
+};
+
+#endif  // RESPONSE_CACHE_H
@@ -1,7 +1,7 @@
 
-#include "RollbackManager.h"
+#include "RollBackManager.h"
 
-void RollbackManager::recordAllocation(ParkingSlot* slot,
+void RollbackManager::recordAllocation(SlotRef slot,
                                        bool previousAvailability,
                                        ParkingRequest* request,
                                        ParkingRequest::State previousRequestState)
@@ -22,9 +22,9 @@ void RollbackManager::rollback(int k)
         AllocationRecord record = history.top();
         history.pop();
 
-        if (record.slot != nullptr)
+        if (record.slot)
         {
-            record.slot->setIsAvailable(record.previousAvailability);
+            record.slot.setIsAvailable(record.previousAvailability);
         }
 
         if (record.request != nullptr)
@@ -4,7 +4,7 @@
 
 #include <stack>
 
-#include "ParkingSlot.h"
+#include "ParkingArea.h"
 #include "ParkingRequest.h"
 
 class RollbackManager
@@ -12,7 +12,7 @@ class RollbackManager
 private:
     struct AllocationRecord
     {
-        ParkingSlot* slot;
+        SlotRef slot;
         bool previousAvailability;
         ParkingRequest* request;
         ParkingRequest::State previousRequestState;
@@ -22,7 +22,7 @@ private:
 
 public:
     // Record an allocation operation so it can be undone later.
-    void recordAllocation(ParkingSlot* slot,
+    void recordAllocation(SlotRef slot,
                           bool previousAvailability,
                           ParkingRequest* request,
                           ParkingRequest::State previousRequestState);
@@ -0,0 +1,186 @@
+#include "SensorListener.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+    // Datagrams are read one at a time; this bounds how many are taken in
+    // one go before the io_context gets to run the flush timer.
+    const int MAX_DATAGRAMS_PER_DRAIN = 1024;
+
+    std::uint32_t readU32(const unsigned char* p)
+    {
+        return static_cast<std::uint32_t>(p[0]) |
+               static_cast<std::uint32_t>(p[1]) << 8 |
+               static_cast<std::uint32_t>(p[2]) << 16 |
+               static_cast<std::uint32_t>(p[3]) << 24;
+    }
+
+    // Sequence numbers compare modulo 2^32 so a long-running sensor may wrap.
+    bool sequenceBefore(std::uint32_t a, std::uint32_t b)
+    {
+        return static_cast<std::int32_t>(a - b) < 0;
+    }
+}
+
+SensorListener::SensorListener(CommandQueue& queue, unsigned short port)
+    : queue(queue),
+      socket(io, asio::ip::udp::endpoint(asio::ip::udp::v4(), port)),
+      ticker(io),
+      datagram(65536)
+{
+    asio::error_code ignored;
+    socket.set_option(asio::socket_base::receive_buffer_size(RECEIVE_BUFFER_BYTES), ignored);
+    socket.non_blocking(true);
+}
+
+SensorListener::~SensorListener()
+{
+    stop();
+}
+
+void SensorListener::start()
+{
+    receive();
+    scheduleFlush();
+    worker = std::thread([this]()
+    {
+        try
+        {
+            io.run();
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "SensorListener error: " << e.what() << std::endl;
+        }
+    });
+}
+
+void SensorListener::stop()
+{
+    io.stop();
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+void SensorListener::receive()
+{
+    socket.async_wait(asio::ip::udp::socket::wait_read,
+        [this](const asio::error_code& ec)
+        {
+            if (ec)
+            {
+                return;
+            }
+            drain();
+            receive();
+        });
+}
+
+void SensorListener::drain()
+{
+    for (int i = 0; i < MAX_DATAGRAMS_PER_DRAIN; ++i)
+    {
+        asio::error_code ec;
+        std::size_t size = socket.receive(asio::buffer(datagram), 0, ec);
+        if (ec == asio::error::would_block || ec == asio::error::try_again)
+        {
+            return;
+        }
+        if (!ec)
+        {
+            parse(datagram.data(), size);
+        }
+    }
+}
+
+void SensorListener::parse(const unsigned char* data, std::size_t size)
+{
+    if (size < HEADER_BYTES || data[0] != 1)
+    {
+        return;
+    }
+
+    std::size_t count = static_cast<std::size_t>(data[2]) | static_cast<std::size_t>(data[3]) << 8;
+    if (size != HEADER_BYTES + count * EVENT_BYTES)
+    {
+        return;
+    }
+
+    const unsigned char* event = data + HEADER_BYTES;
+    for (std::size_t i = 0; i < count; ++i, event += EVENT_BYTES)
+    {
+        Event parsed;
+        parsed.slot = static_cast<std::uint64_t>(readU32(event)) << 32 | readU32(event + 4);
+        parsed.sequence = readU32(event + 8);
+        parsed.occupied = event[12] != 0;
+        pending.push_back(parsed);
+    }
+}
+
+void SensorListener::scheduleFlush()
+{
+    ticker.expires_after(FLUSH_INTERVAL);
+    ticker.async_wait([this](const asio::error_code& ec)
+    {
+        if (!ec)
+        {
+            flush();
+            scheduleFlush();
+        }
+    });
+}
+
+void SensorListener::flush()
+{
+    std::sort(pending.begin(), pending.end(), [](const Event& a, const Event& b)
+    {
+        return a.slot != b.slot ? a.slot < b.slot : sequenceBefore(a.sequence, b.sequence);
+    });
+
+    for (const Event& event : pending)
+    {
+        auto found = tracks.find(event.slot);
+        if (found == tracks.end())
+        {
+            if (tracks.size() >= MAX_TRACKED_SLOTS)
+            {
+                continue;
+            }
+            // First word from this slot: pass it on, the model decides
+            // whether it is a change.
+            tracks.emplace(event.slot, Track{ event.sequence, event.occupied });
+        }
+        else
+        {
+            Track& track = found->second;
+            if (!sequenceBefore(track.sequence, event.sequence))
+            {
+                continue;  // duplicate, or older than what was applied
+            }
+            track.sequence = event.sequence;
+            if (track.occupied == event.occupied)
+            {
+                continue;  // heartbeat
+            }
+            track.occupied = event.occupied;
+        }
+
+        CommandQueue::SlotReading reading;
+        reading.zoneId = static_cast<int>(event.slot >> 32);
+        reading.slotId = static_cast<int>(static_cast<std::uint32_t>(event.slot));
+        reading.occupied = event.occupied;
+        readings.push_back(reading);
+    }
+    pending.clear();
+
+    // When the queue is full the readings stay here and go out, in order,
+    // with the next interval's.
+    if (!readings.empty() && queue.applySlotReadings(readings, CommandQueue::Done()))
+    {
+        readings.clear();
+    }
+}
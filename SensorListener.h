@@ -0,0 +1,102 @@
+#ifndef SENSOR_LISTENER_H
+#define SENSOR_LISTENER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifndef ASIO_STANDALONE
+#define ASIO_STANDALONE
+#endif
+#include <asio.hpp>
+
+#include "CommandQueue.h"
+
+// UDP ingestion of per-slot ground sensor events.
+//
+// Datagram layout (little-endian):
+//    0  u8   version   1
+//    1  u8   reserved  0
+//    2  u16  count     number of events that follow
+//    4  count x 16-byte events:
+//         0  i32  zoneId    \ slot handle
+//         4  i32  slotId    /
+//         8  u32  sequence  per slot, increasing (wraps)
+//        12  u8   state     0 vacant, 1 occupied
+//        13  u8[3] reserved
+// Datagrams whose size does not match count are dropped whole.
+//
+// UDP may duplicate and reorder. Events are held for one FLUSH_INTERVAL,
+// then sorted by slot and sequence; an event is kept only if its sequence
+// is newer than the last one seen for the slot and it changes the slot's
+// state. Events older than something already applied are dropped. What is
+// left goes to CommandQueue as a single SLOT_READINGS command, so a whole
+// interval's worth of arrivals and departures is applied under one lock
+// and published as one snapshot.
+//
+// Receiving never waits on the model: after each wakeup the socket is
+// drained without blocking, and the kernel buffer is enlarged to absorb
+// bursts while a flush is sorting.
+//
+// Runs on its own io_context and thread, alongside the Crow app.
+class SensorListener
+{
+public:
+    static const std::size_t EVENT_BYTES = 16;
+    static const std::size_t HEADER_BYTES = 4;
+
+    // Reorder window; also the longest an event waits before being applied.
+    static constexpr std::chrono::milliseconds FLUSH_INTERVAL{ 10 };
+
+    // Requested SO_RCVBUF (the kernel may cap it, see net.core.rmem_max).
+    static const int RECEIVE_BUFFER_BYTES = 8 * 1024 * 1024;
+
+    // Slots beyond this many are not tracked (events for them are dropped).
+    static const std::size_t MAX_TRACKED_SLOTS = 1 << 20;
+
+    SensorListener(CommandQueue& queue, unsigned short port);
+    ~SensorListener();
+
+    SensorListener(const SensorListener&) = delete;
+    SensorListener& operator=(const SensorListener&) = delete;
+
+    void start();
+    void stop();
+
+private:
+    struct Event
+    {
+        std::uint64_t slot;  // zoneId << 32 | slotId
+        std::uint32_t sequence;
+        bool occupied;
+    };
+
+    struct Track
+    {
+        std::uint32_t sequence;
+        bool occupied;
+    };
+
+    CommandQueue& queue;
+    asio::io_context io;
+    asio::ip::udp::socket socket;
+    asio::steady_timer ticker;
+    std::thread worker;
+
+    // Only touched on the io thread.
+    std::vector<unsigned char> datagram;
+    std::vector<Event> pending;
+    std::unordered_map<std::uint64_t, Track> tracks;
+    std::vector<CommandQueue::SlotReading> readings;
+
+    void receive();
+    void drain();
+    void parse(const unsigned char* data, std::size_t size);
+    void scheduleFlush();
+    void flush();
+};
+
+#endif  // SENSOR_LISTENER_H
@@ -6,24 +6,46 @@
 // NOTE: No business logic is embedded here; handlers only call into ParkingSystem
 // and serialize results as JSON.
 
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
 #include <iostream>
-#include <sstream>
-#include <iomanip>
+#include <string_view>
+
+#ifndef _WIN32
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
 
 // Using Crow (already vendored in this repo) as a lightweight C++ HTTP server.
 // If you want cpp-httplib specifically, we can swap the server layer later.
 #include "server/Crow-master/include/crow.h"
 
-// IMPORTANT: We do NOT modify core classes to add getters.
-// The existing core model hides internals; to expose analytics without changing core,
-// we use a server-layer-only compile-time access workaround.
-#define private public
+#include "Awaitables.h"
+#include "CommandQueue.h"
+#include "GateServer.h"
+#include "HttpCompression.h"
+#include "JsonWriter.h"
+#include "OccupancyArchive.h"
+#include "OccupancyFeed.h"
+#include "ResponseCache.h"
+#include "SensorListener.h"
+#include "SnapshotJson.h"
+#include "StreamServer.h"
+
+// Read handlers only ever see immutable ParkingSnapshot objects published by
+// ParkingSystem, so they never race with (or block) mutating requests.
 #include "ParkingSystem.h"
+#include "ParkingSnapshot.h"
 #include "Zone.h"
 #include "ParkingArea.h"
 #include "ParkingSlot.h"
 #include "ParkingRequest.h"
-#undef private
 
 // ----------------------------- CORS Middleware --------------------------------------
 
@@ -36,7 +58,7 @@ struct CorsMiddleware {
             res.code = 200;
             res.set_header("Access-Control-Allow-Origin", "*");
             res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-            res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
+            res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization, If-None-Match");
             res.set_header("Access-Control-Max-Age", "3600");
             res.set_header("Content-Type", "application/json; charset=utf-8");
             res.body = "{}";
@@ -52,8 +74,9 @@ struct CorsMiddleware {
         // Use set_header to overwrite any existing CORS headers (prevents duplicates)
         res.set_header("Access-Control-Allow-Origin", "*");
         res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-        res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
+        res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization, If-None-Match");
         res.set_header("Access-Control-Max-Age", "3600");
+        res.set_header("Access-Control-Expose-Headers", "ETag");
     }
 };
 
@@ -68,52 +91,172 @@ static inline int roundPercent(int numerator, int denominator) {
 static inline void addCors(crow::response& res) {
     res.add_header("Access-Control-Allow-Origin", "*");
     res.add_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-    res.add_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
+    res.add_header("Access-Control-Allow-Headers", "Content-Type, Authorization, If-None-Match");
     res.add_header("Access-Control-Max-Age", "3600");
 }
 
-// Very small JSON builder (to avoid adding a JSON dependency).
-static inline std::string jsonEscape(const std::string& s) {
-    std::ostringstream out;
-    for (char c : s) {
-        switch (c) {
-            case '\\': out << "\\\\"; break;
-            case '\"': out << "\\\""; break;
-            case '\n': out << "\\n"; break;
-            case '\r': out << "\\r"; break;
-            case '\t': out << "\\t"; break;
-            default:
-                if (static_cast<unsigned char>(c) < 0x20) {
-                    out << "\\u"
-                        << std::hex << std::uppercase << std::setfill('0') << std::setw(4)
-                        << (int)(unsigned char)c;
-                } else {
-                    out << c;
-                }
+// All JSON bodies are built with JsonWriter, which appends into a thread-local
+// buffer (no ostringstream, no per-field allocations).
+static inline crow::response jsonResponse(int code, const JsonWriter& json) {
+    crow::response res(code);
+    res.set_header("Content-Type", "application/json; charset=utf-8");
+    res.body = json.str();
+    return res;
+}
+
+// gzip/deflate per Accept-Encoding. Versioned bodies are large and very
+// repetitive (zone slot lists, request pages), typically ~10x smaller.
+static inline HttpCompression::Encoding acceptedEncoding(const crow::request& req) {
+    return HttpCompression::negotiate(req.get_header_value("Accept-Encoding"));
+}
+
+// Each coding of a version's body is its own representation with its own
+// strong ETag: "42", "42-gzip", "42-deflate".
+static inline std::string_view codingTag(HttpCompression::Encoding encoding) {
+    return encoding == HttpCompression::IDENTITY ? std::string_view() : HttpCompression::headerValue(encoding);
+}
+
+// Serves a read endpoint from the version-tagged cache.
+// - If the client already holds the current version (If-None-Match), answer 304.
+// - Otherwise reuse the cached body when it was built at the current version,
+//   or render it from the current snapshot with
+//   `write(const ParkingSnapshot&, JsonWriter&)` and cache it.
+// `write` returns false when the resource does not exist (-> 404, not cached).
+//
+// True if If-None-Match names a representation of `version` this request
+// may be sent: the plain body (fine for any client) or the negotiated
+// coding. `etag` is the one it names, for the 304.
+static inline bool notModified(const crow::request& req, std::uint64_t version, std::string& etag) {
+    const std::string& ifNoneMatch = req.get_header_value("If-None-Match");
+    if (ifNoneMatch.empty()) return false;
+
+    for (HttpCompression::Encoding encoding : { HttpCompression::IDENTITY, acceptedEncoding(req) }) {
+        if (ResponseCache::etagMatches(ifNoneMatch, version, codingTag(encoding))) {
+            etag = ResponseCache::makeETag(version, codingTag(encoding));
+            return true;
         }
     }
-    return out.str();
+    return false;
+}
+
+static inline crow::response notModifiedResponse(const std::string& etag) {
+    crow::response res(304);
+    res.set_header("ETag", etag);
+    res.set_header("Cache-Control", "no-cache");
+    res.set_header("Vary", "Accept-Encoding");
+    return res;
+}
+
+// 200 for a body rendered from the snapshot at `version` (not cached):
+// ETag/no-cache like cachedJson, compressed for this request if accepted.
+static crow::response versionedResponse(const crow::request& req, const JsonWriter& json, std::uint64_t version) {
+    crow::response res(200);
+    res.set_header("Content-Type", "application/json; charset=utf-8");
+    res.set_header("Cache-Control", "no-cache");
+    res.set_header("Vary", "Accept-Encoding");
+
+    HttpCompression::Encoding encoding = acceptedEncoding(req);
+    if (HttpCompression::compress(json.buffer(), encoding, res.body)) {
+        res.set_header("Content-Encoding", HttpCompression::headerValue(encoding));
+    } else {
+        encoding = HttpCompression::IDENTITY;
+        res.body = json.str();
+    }
+    res.set_header("ETag", ResponseCache::makeETag(version, codingTag(encoding)));
+    return res;
+}
+
+template <typename Writer>
+static crow::response cachedJson(const crow::request& req,
+                                 ParkingSystem& ps,
+                                 ResponseCache& cache,
+                                 const std::string& key,
+                                 Writer write) {
+    std::uint64_t version = ps.getStateVersion();
+    std::string held;
+    if (notModified(req, version, held)) return notModifiedResponse(held);
+
+    auto entry = cache.find(key, version);
+    if (!entry) {
+        // Tag the body with the version of the snapshot it was rendered from.
+        auto snapshot = ps.getSnapshot();
+        JsonWriter json;
+        if (!write(*snapshot, json)) return crow::response(404);
+        entry = cache.store(key, snapshot->version, json.str());
+    }
+
+    crow::response res(200);
+    res.set_header("Content-Type", "application/json; charset=utf-8");
+    // no-cache: browsers keep the body but revalidate with If-None-Match every poll.
+    res.set_header("Cache-Control", "no-cache");
+    res.set_header("Vary", "Accept-Encoding");
+
+    // Compressed at most once per entry (i.e. per state version).
+    HttpCompression::Encoding encoding = acceptedEncoding(req);
+    if (const std::string* compressed = entry->compressed(encoding)) {
+        res.set_header("Content-Encoding", HttpCompression::headerValue(encoding));
+        res.body = *compressed;
+    } else {
+        encoding = HttpCompression::IDENTITY;
+        res.body = entry->body;
+    }
+    res.set_header("ETag", ResponseCache::makeETag(entry->version, codingTag(encoding)));
+    return res;
+}
+
+// Like cachedJson, for responses that depend on query parameters and are
+// therefore not worth caching: still ETag/304 aware, rendered on a miss.
+template <typename Writer>
+static crow::response versionedJson(const crow::request& req, ParkingSystem& ps, Writer write) {
+    std::uint64_t version = ps.getStateVersion();
+    std::string held;
+    if (notModified(req, version, held)) return notModifiedResponse(held);
+
+    auto snapshot = ps.getSnapshot();
+    JsonWriter json;
+    if (!write(*snapshot, json)) return crow::response(404);
+
+    return versionedResponse(req, json, snapshot->version);
+}
+
+// Formats "Zone <id>" into a caller-provided stack buffer.
+static inline std::string_view zoneName(char (&buf)[32], int zoneId) {
+    std::memcpy(buf, "Zone ", 5);
+    auto result = std::to_chars(buf + 5, buf + sizeof(buf), zoneId);
+    return std::string_view(buf, static_cast<size_t>(result.ptr - buf));
+}
+
+// Parses an optional non-negative integer query parameter.
+// Returns false if the parameter is present but not a valid number.
+static inline bool queryInt(const crow::request& req, const char* name, long long fallback, long long& out) {
+    const char* raw = req.url_params.get(name);
+    if (raw == nullptr) {
+        out = fallback;
+        return true;
+    }
+    const char* end = raw + std::strlen(raw);
+    auto result = std::from_chars(raw, end, out);
+    return result.ec == std::errc() && result.ptr == end && out >= 0;
 }
 
 // Seed some demo zones/slots so GET endpoints return non-empty data.
 static void seedDemo(ParkingSystem& ps) {
     // Zone 1: total 7 slots (1 area)
     Zone z1(1);
-    ParkingArea a11(1);
-    for (int i = 1; i <= 7; ++i) {
-        a11.addParkingSlot(ParkingSlot(i, 1));
-    }
-    z1.addParkingArea(a11);
-    ps.addZone(z1);
+    z1.addArea(1, 7);
+    ps.emplaceZone(std::move(z1));
 
     // Zone 2: total 6 slots (1 area)
     Zone z2(2);
-    ParkingArea a21(1);
-    for (int i = 1; i <= 6; ++i) {
-        a21.addParkingSlot(ParkingSlot(i, 2));
-    }
-    z2.addParkingArea(a21);
-    ps.addZone(z2);
+    z2.addArea(1, 6);
+    ps.emplaceZone(std::move(z2));
+
+    // Demo site: one campus, one building, one level holding both zones.
+    int campus = ps.addFacilityNode(-1, "campus", "Main Campus");
+    int building = ps.addFacilityNode(campus, "building", "Building A");
+    int level = ps.addFacilityNode(building, "level", "Level 1");
+    ps.attachZoneToFacility(level, 1);
+    ps.attachZoneToFacility(level, 2);
 
     // Create a couple of requests to show occupancy + activeRequests
     // These call into core logic and will mark slots as occupied (isAvailable=false).
@@ -124,250 +267,873 @@ static void seedDemo(ParkingSystem& ps) {
 
 // ----------------------------- Routes ---------------------------------------
 
-// ----------------------------- Routes ---------------------------------------
+static bool writeZones(const ParkingSnapshot& snap, JsonWriter& json) {
+    json.beginObject().key("zones").beginArray();
+    for (std::size_t i = 0; i < snap.zones.size(); ++i) {
+        const ZoneSnapshot* zone = snap.zones[i].get();
+        char name[32];
+        json.beginObject()
+            .field("id", zone->zoneId)
+            .field("name", zoneName(name, zone->zoneId))
+            .field("capacity", zone->capacity)
+            .field("occupiedSlots", zone->occupiedSlots) // Frontend uses this
+            .field("utilization", roundPercent(zone->occupiedSlots, zone->capacity))
+            .field("priceCents", snap.prices[i].cents)
+            .endObject();
+    }
+    json.endArray().endObject();
+    return true;
+}
 
-static crow::response handleGetZones(ParkingSystem& ps) {
-    std::ostringstream out;
-    out << "{\"zones\":[";
-    bool first = true;
-    for (const auto& zone : ps.zones) {
-        if (!first) out << ",";
-        first = false;
-        
-        int total = 0, occupied = 0;
-        for (const auto& area : zone.parkingAreas) {
-            for (const auto& slot : area.slots) {
-                total++;
-                if (!slot.isAvailable) occupied++;
+static crow::response handleGetZones(const crow::request& req, ParkingSystem& ps, ResponseCache& cache) {
+    static const std::string key = "zones";
+    return cachedJson(req, ps, cache, key, writeZones);
+}
+
+// "type" is only written for non-standard bays.
+static void writeSlot(JsonWriter& json, int slotId, bool occupied, std::string_view vehicleId, int type) {
+    json.beginObject()
+        .field("id", slotId)
+        .field("occupied", occupied);
+    if (type != static_cast<int>(ParkingSlot::Type::STANDARD)) {
+        json.field("type", ParkingSlot::typeToString(static_cast<ParkingSlot::Type>(type)));
+    }
+    json.key("vehicle").beginObject()
+            .field("vehicleId", vehicleId)
+            .field("ownerName", "Guest") // Model doesn't have owner
+        .endObject()
+        .endObject();
+}
+
+static void beginZoneDetail(JsonWriter& json, const ZoneSnapshot& zone) {
+    char name[32];
+    json.beginObject()
+        .field("id", zone.zoneId)
+        .field("name", zoneName(name, zone.zoneId))
+        .key("slots").beginArray();
+}
+
+static bool writeZoneDetail(const ParkingSnapshot& snap, int id, JsonWriter& json) {
+    const ZoneSnapshot* zone = snap.findZone(id);
+    if (zone == nullptr) return false;
+
+    beginZoneDetail(json, *zone);
+    for (const SlotLayout::Span& span : zone->layout->spans) {
+        for (int k = 0; k < span.count; ++k) {
+            // The snapshot records which request holds each slot.
+            std::string_view vehicleId;
+            int holder = zone->holders[span.firstIndex + k];
+            if (holder >= 0) {
+                vehicleId = snap.getRequest(holder).vehicleId;
             }
+            writeSlot(json, span.firstSlotId + k, holder != ZoneSnapshot::FREE, vehicleId, span.type);
         }
-        int ut = roundPercent(occupied, total);
-
-        out << "{"
-            << "\"id\":" << zone.zoneId << ","
-            << "\"name\":\"Zone " << zone.zoneId << "\","
-            << "\"capacity\":" << total << ","
-            << "\"occupiedSlots\":" << occupied << "," // Frontend uses this
-            << "\"utilization\":" << ut
-            << "}";
     }
-    out << "]}";
-    crow::response res(200);
-    res.set_header("Content-Type", "application/json");
-    res.body = out.str();
-    return res;
+    json.endArray().endObject();
+    return true;
 }
 
-static crow::response handleGetZoneDetail(ParkingSystem& ps, int id) {
-    for (const auto& zone : ps.zones) {
-        if (zone.zoneId == id) {
-            std::ostringstream out;
-            out << "{"
-                << "\"id\":" << zone.zoneId << ","
-                << "\"name\":\"Zone " << zone.zoneId << "\","
-                << "\"slots\":[";
-            
-            bool firstSlot = true;
-            for (const auto& area : zone.parkingAreas) {
-                for (const auto& slot : area.slots) {
-                    if (!firstSlot) out << ",";
-                    firstSlot = false;
-                    
-                    std::string vehicleId = "";
-                    std::string ownerName = "";
-                    
-                    // Find vehicle in this slot? 
-                    // The core model is limited, we have to search active requests or vehicles map if it existed.
-                    // Accessing slot directly:
-                    bool isOcc = !slot.isAvailable;
-                    // For demo, we trying to find if a vehicle is here.
-                    // But ParkingSlot doesn't store vehicle ID directly in this version?
-                    // Checking ParkingSlot.h would be good, but assuming standard logic:
-                    // Using the requests list to find vehicle for this slot if occupied.
-                    if (isOcc) {
-                        for(const auto& req : ps.requests) {
-                             if(req.allocatedZoneId == zone.zoneId && req.allocatedSlotId == slot.slotId && 
-                                (req.currentState == ParkingRequest::State::ALLOCATED || req.currentState == ParkingRequest::State::OCCUPIED)) {
-                                 vehicleId = req.vehicle.licensePlate;
-                                 ownerName = "Owner"; // Model doesn't have owner
-                                 break;
-                             }
-                        }
-                    }
-
-                    out << "{"
-                        << "\"id\":" << slot.slotId << ","
-                        << "\"occupied\":" << (isOcc ? "true" : "false") << ","
-                        << "\"vehicle\": {"
-                        << "\"vehicleId\": \"" << jsonEscape(vehicleId) << "\","
-                        << "\"ownerName\": \"Guest\""
-                        << "}"
-                        << "}";
+// GET /api/zones/<id>?state=FREE|OCCUPIED|ALLOCATED&vehicle=PLATE
+// Slot-level states: OCCUPIED = any held slot (the "occupied" flag in the
+// slot JSON), ALLOCATED = held but the car has not arrived yet, FREE = not held.
+// Held slots come from the per-zone index of active requests (O(results));
+// FREE walks the zone's slot holders.
+static crow::response handleFilteredZoneDetail(const crow::request& req, ParkingSystem& ps, int id) {
+    const char* stateParam = req.url_params.get("state");
+    const char* vehicleParam = req.url_params.get("vehicle");
+
+    std::uint64_t version = ps.getStateVersion();
+    std::string held;
+    if (notModified(req, version, held)) return notModifiedResponse(held);
+
+    if (stateParam != nullptr && std::strcmp(stateParam, "FREE") == 0) {
+        if (vehicleParam != nullptr) return crow::response(400, "vehicle cannot be combined with state=FREE");
+
+        auto snap = ps.getSnapshot();
+        const ZoneSnapshot* zone = snap->findZone(id);
+        if (zone == nullptr) return crow::response(404);
+
+        JsonWriter json;
+        beginZoneDetail(json, *zone);
+        for (const SlotLayout::Span& span : zone->layout->spans) {
+            for (int k = 0; k < span.count; ++k) {
+                if (!zone->isOccupied(span.firstIndex + k)) {
+                    writeSlot(json, span.firstSlotId + k, false, std::string_view(), span.type);
                 }
             }
-            out << "]}";
-            
-            crow::response res(200);
-            res.set_header("Content-Type", "application/json");
-            res.body = out.str();
-            return res;
         }
+        json.endArray().endObject();
+
+        return versionedResponse(req, json, snap->version);
+    }
+
+    RequestQuery query;
+    query.zoneId = id;
+    query.activeOnly = true;
+    if (stateParam != nullptr && std::strcmp(stateParam, "OCCUPIED") != 0) {
+        if (std::strcmp(stateParam, "ALLOCATED") != 0) return crow::response(400, "unknown state");
+        query.hasState = true;
+        query.state = ParkingRequest::State::ALLOCATED;
+    }
+    if (vehicleParam != nullptr) query.vehicleId = vehicleParam;
+
+    auto result = ps.queryRequests(query);
+    const ZoneSnapshot* zone = result.snapshot->findZone(id);
+    if (zone == nullptr) return crow::response(404);
+
+    JsonWriter json;
+    beginZoneDetail(json, *zone);
+    for (int requestId : result.requestIds) {
+        const RequestRecord& record = result.snapshot->getRequest(requestId);
+        if (record.slotCount <= 1) {
+            writeSlot(json, record.allocatedSlotId, true, record.vehicleId, record.slotType);
+            continue;
+        }
+        // A multi-slot request holds adjacent positions from its first slot.
+        int first = zone->indexOf(record.allocatedSlotId);
+        if (first < 0) continue;
+        int end = std::min(first + record.slotCount, zone->capacity);
+        for (int i = first; i < end; ++i) {
+            writeSlot(json, zone->layout->slotIdAt(i), true, record.vehicleId, zone->layout->typeAt(i));
+        }
+    }
+    json.endArray().endObject();
+
+    return versionedResponse(req, json, result.snapshot->version);
+}
+
+static crow::response handleGetZoneDetail(const crow::request& req, ParkingSystem& ps, ResponseCache& cache, int id) {
+    if (req.url_params.get("state") != nullptr || req.url_params.get("vehicle") != nullptr) {
+        return handleFilteredZoneDetail(req, ps, id);
     }
-    return crow::response(404);
+
+    return cachedJson(req, ps, cache, "zones/" + std::to_string(id),
+                      [id](const ParkingSnapshot& snap, JsonWriter& json) {
+        return writeZoneDetail(snap, id, json);
+    });
+}
+
+// ---- Mutations ----
+// Mutating handlers are coroutines: they validate input, submit a command to
+// the single-writer CommandQueue and suspend until the writer has applied
+// and published it (awaitCommand), so no Crow worker blocks on the core.
+
+// Queue full: shed load rather than buffering without bound.
+static crow::response busyResponse() {
+    crow::response res(503);
+    res.set_header("Retry-After", "1");
+    return res;
 }
 
-static crow::response handleCreateZone(crow::request& req, ParkingSystem& ps) {
+static asio::awaitable<crow::response> handleCreateZone(const crow::request& req, ParkingSystem& ps,
+                                                        CommandQueue& queue) {
     auto x = crow::json::load(req.body);
-    if (!x) return crow::response(400, "Invalid JSON");
+    if (!x) co_return crow::response(400, "Invalid JSON");
     
     int id = x["id"].i();
+    // Checked again by the writer, which settles two concurrent creates.
+    if (ps.getSnapshot()->findZone(id)) co_return crow::response(409, "zone already exists");
     // Simplified: Just creating a zone with areas
     Zone z(id);
     
     if (x.has("areas")) {
+        // Each area is allocated once and filled in place; addArea numbers
+        // slots across the whole zone so (zoneId, slotId) is unique.
+        z.reserveAreas(x["areas"].size());
         for (const auto& areaJson : x["areas"]) {
-            int areaId = areaJson["areaId"].i();
-            int slots = areaJson["slots"].i();
-            ParkingArea pa(areaId);
-            for(int i=1; i<=slots; i++) {
-                pa.addParkingSlot(ParkingSlot(i, areaId)); // Assuming slot constructor
+            // Optional "slotType" (e.g. "EV") applies to every slot of the area.
+            ParkingSlot::Type type = ParkingSlot::Type::STANDARD;
+            if (areaJson.has("slotType") && !ParkingSlot::typeFromString(areaJson["slotType"].s(), type)) {
+                co_return crow::response(400, "unknown slotType");
             }
-            z.addParkingArea(pa);
+            ParkingArea& area = z.addArea(static_cast<int>(areaJson["areaId"].i()),
+                                          static_cast<int>(areaJson["slots"].i()), static_cast<int>(type));
+            // Optional charging feed shared by the area's bays.
+            if (areaJson.has("powerBudgetWatts")) area.setPowerBudget(static_cast<int>(areaJson["powerBudgetWatts"].i()));
         }
     }
     
-    ps.addZone(z);
-    return crow::response(201);
+    CommandOutcome outcome = co_await awaitCommand([&](CommandQueue::Done done) {
+        return queue.addZone(std::move(z), std::move(done));
+    });
+    if (!outcome.queued) co_return busyResponse();
+    if (outcome.result != 1) co_return crow::response(409, "zone already exists");
+    co_return crow::response(201);
 }
 
-static crow::response handleGetRequests(ParkingSystem& ps) {
-    std::ostringstream out;
-    out << "{\"requests\":[";
-    bool first = true;
-    for (const auto& req : ps.requests) {
-        if (!first) out << ",";
-        first = false;
-        
-        std::string status = "UNKNOWN";
-        switch(req.currentState) {
-            case ParkingRequest::State::REQUESTED: status = "REQUESTED"; break;
-            case ParkingRequest::State::ALLOCATED: status = "ALLOCATED"; break;
-            case ParkingRequest::State::OCCUPIED: status = "OCCUPIED"; break;
-            case ParkingRequest::State::COMPLETED: status = "RELEASED"; break; // Map valid status
-            case ParkingRequest::State::CANCELLED: status = "CANCELLED"; break; // If exists in enum
-            default: status = "RELEASED";
-        }
-        
-        out << "{"
-            << "\"id\":" << req.requestId << ","
-            << "\"vehicleId\":\"" << jsonEscape(req.vehicle.licensePlate) << "\","
-            << "\"zoneId\":" << req.allocatedZoneId << ","
-            << "\"slotNumber\":" << req.allocatedSlotId << ","
-            << "\"status\":\"" << status << "\","
-            << "\"timestamp\":\"Recently\""
-            << "}";
-    }
-    out << "]}";
-    crow::response res(200);
-    res.set_header("Content-Type", "application/json");
-    res.body = out.str();
-    return res;
+static bool writeRequests(const ParkingSnapshot& snap, JsonWriter& json) {
+    json.beginObject().key("requests").beginArray();
+    for (int id = 0; id < snap.requestCount; ++id) {
+        writeRequestRecord(json, snap.getRequest(id));
+    }
+    json.endArray().endObject();
+    return true;
+}
+
+// One page of requests starting at id `cursor`. Request ids are dense
+// indexes, so seeking is O(1) and the page costs O(limit).
+static bool writeRequestPage(const ParkingSnapshot& snap, long long cursor, long long limit, JsonWriter& json) {
+    // cursor may be anything up to LLONG_MAX, so compare before adding.
+    long long end = cursor >= snap.requestCount || limit >= snap.requestCount - cursor ? snap.requestCount
+                                                                                      : cursor + limit;
+
+    json.beginObject().key("requests").beginArray();
+    for (long long id = cursor; id < end; ++id) {
+        writeRequestRecord(json, snap.getRequest(static_cast<int>(id)));
+    }
+    json.endArray();
+
+    json.key("nextCursor");
+    if (end < snap.requestCount) {
+        json.value(end);
+    } else {
+        json.null();
+    }
+    json.endObject();
+    return true;
 }
 
-static crow::response handleCreateRequest(crow::request& req, ParkingSystem& ps) {
+static const long long DEFAULT_PAGE_SIZE = 100;
+static const long long MAX_PAGE_SIZE = 1000;
+
+static bool hasRequestFilter(const crow::request& req) {
+    return req.url_params.get("state") != nullptr || req.url_params.get("zone") != nullptr ||
+           req.url_params.get("vehicle") != nullptr || req.url_params.get("from") != nullptr ||
+           req.url_params.get("to") != nullptr;
+}
+
+// Filtered listing: answered from ParkingSystem's membership indexes, so it
+// costs O(most selective index) instead of O(all requests).
+static crow::response handleFilteredRequests(const crow::request& req, ParkingSystem& ps, long long cursor, long long limit) {
+    RequestQuery query;
+    query.cursor = static_cast<int>(std::min<long long>(cursor, INT_MAX));
+    query.limit = static_cast<int>(limit);
+
+    if (const char* state = req.url_params.get("state")) {
+        if (!ParkingRequest::stateFromString(state, query.state)) return crow::response(400, "unknown state");
+        query.hasState = true;
+    }
+    if (const char* vehicle = req.url_params.get("vehicle")) {
+        query.vehicleId = vehicle;
+    }
+    long long zone = 0;
+    if (!queryInt(req, "zone", -1, zone) ||
+        !queryInt(req, "from", -1, query.fromTime) ||
+        !queryInt(req, "to", -1, query.toTime)) {
+        return crow::response(400, "zone, from and to must be non-negative integers");
+    }
+    query.zoneId = static_cast<int>(std::min<long long>(zone, INT_MAX));
+
+    std::uint64_t version = ps.getStateVersion();
+    std::string held;
+    if (notModified(req, version, held)) return notModifiedResponse(held);
+
+    auto result = ps.queryRequests(query);
+
+    JsonWriter json;
+    json.beginObject().key("requests").beginArray();
+    for (int requestId : result.requestIds) {
+        writeRequestRecord(json, result.snapshot->getRequest(requestId));
+    }
+    json.endArray().key("nextCursor");
+    if (result.nextCursor >= 0) {
+        json.value(result.nextCursor);
+    } else {
+        json.null();
+    }
+    json.endObject();
+
+    return versionedResponse(req, json, result.snapshot->version);
+}
+
+// GET /api/parking/requests[?limit=N&cursor=ID][&state=S&zone=Z&vehicle=V&from=T&to=T]
+// Without parameters the full (cached) listing is returned, as before.
+// Large exports should use the chunked stream on the StreamServer instead.
+static crow::response handleGetRequests(const crow::request& req, ParkingSystem& ps, ResponseCache& cache) {
+    bool filtered = hasRequestFilter(req);
+    if (!filtered && req.url_params.get("limit") == nullptr && req.url_params.get("cursor") == nullptr) {
+        static const std::string key = "parking/requests";
+        return cachedJson(req, ps, cache, key, writeRequests);
+    }
+
+    long long limit = 0, cursor = 0;
+    if (!queryInt(req, "limit", DEFAULT_PAGE_SIZE, limit) || !queryInt(req, "cursor", 0, cursor)) {
+        return crow::response(400, "limit and cursor must be non-negative integers");
+    }
+    limit = std::min(std::max(limit, 1LL), MAX_PAGE_SIZE);
+
+    if (filtered) return handleFilteredRequests(req, ps, cursor, limit);
+
+    return versionedJson(req, ps, [cursor, limit](const ParkingSnapshot& snap, JsonWriter& json) {
+        return writeRequestPage(snap, cursor, limit, json);
+    });
+}
+
+// GET /api/zones/<id>/wait?timeout=<ms>
+// Long-poll for a free slot instead of retrying POST /api/parking/requests.
+// Only slots an untyped request may take (STANDARD, OVERSIZED) count, so a
+// freed EV bay does not wake a waiter that would then fail to park.
+// The coroutine suspends on the zone's waitlist (see awaitFreeSlot), so a
+// parked request holds no worker thread.
+static const long long DEFAULT_WAIT_MS = 30000;
+static const long long MAX_WAIT_MS = 120000;
+
+static asio::awaitable<crow::response> handleWaitForSlot(const crow::request& req, ParkingSystem& ps, int zoneId) {
+    long long timeoutMs;
+    if (!queryInt(req, "timeout", DEFAULT_WAIT_MS, timeoutMs)) co_return crow::response(400, "Invalid timeout");
+    timeoutMs = std::min(timeoutMs, MAX_WAIT_MS);
+
+    if (ps.getSnapshot()->findZone(zoneId) == nullptr) co_return crow::response(404);
+
+    bool available = co_await awaitFreeSlot(ps, zoneId, std::chrono::milliseconds(timeoutMs));
+
+    auto snapshot = ps.getSnapshot();
+    const ZoneSnapshot* zone = snapshot->findZone(zoneId);
+    int freeSlots = zone ? zone->freeStandard : 0;
+
+    JsonWriter json;
+    json.beginObject()
+        .field("zoneId", zoneId)
+        .field("available", available)
+        .field("freeSlots", freeSlots)
+        .endObject();
+    crow::response res = jsonResponse(200, json);
+    res.set_header("Cache-Control", "no-store");
+    co_return res;
+}
+
+static asio::awaitable<crow::response> handleCreateRequest(const crow::request& req, CommandQueue& queue) {
     auto x = crow::json::load(req.body);
-    if (!x) return crow::response(400);
+    if (!x) co_return crow::response(400);
     
     std::string vid = x["vehicleId"].s();
     int zoneId = x["requestedZoneId"].i();
+
+    // Optional: that many adjacent slots in one area, claimed all at once.
+    int slotCount = x.has("slotCount") ? static_cast<int>(x["slotCount"].i()) : 1;
+    if (slotCount < 1) co_return crow::response(400, "slotCount must be at least 1");
+
+    // Optional vehicle class (e.g. "EV"): only bays that class may use.
+    int vehicleClass = ParkingSystem::ANY_VEHICLE_CLASS;
+    if (x.has("vehicleClass")) {
+        ParkingSlot::Type type;
+        if (!ParkingSlot::typeFromString(x["vehicleClass"].s(), type)) co_return crow::response(400, "unknown vehicleClass");
+        vehicleClass = static_cast<int>(type);
+    }
+
+    // Optional charge rate; implies (and requires) an EV bay.
+    int chargeWatts = x.has("chargeWatts") ? static_cast<int>(x["chargeWatts"].i()) : 0;
+    if (chargeWatts < 0) co_return crow::response(400, "chargeWatts must not be negative");
+    if (chargeWatts > 0) {
+        if (vehicleClass == ParkingSystem::ANY_VEHICLE_CLASS) vehicleClass = static_cast<int>(ParkingSlot::Type::EV);
+        if (vehicleClass != static_cast<int>(ParkingSlot::Type::EV)) co_return crow::response(400, "chargeWatts requires vehicleClass EV");
+        if (slotCount != 1) co_return crow::response(400, "chargeWatts requires a single slot");
+    }
     
-    // Core logic wrapper
-    // The core `requestParking` creates request AND tries to allocate usually?
-    // Let's check how we used it in seed: `ps.requestParking(vid, zoneId)`
-    // It returns bool. 
-    // We need to find the request object it created to return ID.
-    
-    bool result = ps.requestParking(vid, zoneId);
-    
-    // Find the last request for this vehicle
-    int newId = 0;
-    if(!ps.requests.empty()) newId = ps.requests.back().requestId;
-    
-    std::ostringstream out;
-    out << "{\"id\": " << newId << ", \"requestId\": " << newId << "}";
-    
-    return crow::response(201, out.str());
+    // requestParking creates the request and allocates a slot in one step.
+    // It yields the new request id, or -1 when no slot is available anywhere.
+    CommandOutcome outcome = co_await awaitCommand([&](CommandQueue::Done done) {
+        return queue.requestParking(std::move(vid), zoneId, std::move(done), slotCount, vehicleClass, chargeWatts);
+    });
+    if (!outcome.queued) co_return busyResponse();
+
+    int newId = outcome.result;
+    JsonWriter json;
+    if (newId < 0) {
+        json.beginObject().field("message", "No parking slot available").endObject();
+        co_return jsonResponse(409, json);
+    }
+
+    json.beginObject().field("id", newId).field("requestId", newId).endObject();
+    co_return jsonResponse(201, json);
 }
 
-static crow::response handleAllocateRequest(crow::request& req, int id, ParkingSystem& ps) {
+static crow::response handleAllocateRequest(const crow::request& req, int id, ParkingSystem& ps) {
     // In this system, requestParking already allocates. 
     // But frontend calls this separately. We can just return 200 OK as mock
     // or try to re-process if pending.
     return crow::response(200);
 }
 
+// PUT /api/parking/requests/<id>/occupy, /cancel and /release.
+// Freeing a slot wakes one client parked on /api/zones/<id>/wait.
+static asio::awaitable<crow::response> finishRequest(int id, ParkingSystem& ps, CommandQueue& queue,
+                                                     CommandQueue::Command::Kind transition) {
+    if (id < 0 || id >= ps.getSnapshot()->requestCount) co_return crow::response(404);
+
+    CommandOutcome outcome = co_await awaitCommand([&](CommandQueue::Done done) {
+        switch (transition) {
+        case CommandQueue::Command::OCCUPY_SLOT: return queue.occupySlot(id, std::move(done));
+        case CommandQueue::Command::RELEASE_SLOT: return queue.releaseSlot(id, std::move(done));
+        default: return queue.cancelRequest(id, std::move(done));
+        }
+    });
+    if (!outcome.queued) co_return busyResponse();
+
+    JsonWriter json;
+    if (outcome.result != 1) {
+        json.beginObject().field("message", "Request cannot change to that state").endObject();
+        co_return jsonResponse(409, json);
+    }
+
+    auto snapshot = ps.getSnapshot();
+    writeRequestRecord(json, snapshot->getRequest(id));
+    co_return jsonResponse(200, json);
+}
+
+// Rates come from RequestStats' running counters, so both analytics
+// endpoints are O(zones) whatever the request history. Percentages are
+// rounded; averageDuration is in minutes.
+static void writeRequestRates(JsonWriter& json, const RequestStats::Counters& counters) {
+    json.field("totalRequests", counters.requests)
+        .field("successRate", counters.successPercent())
+        .field("fallbackRate", counters.fallbackPercent())
+        .field("cancellationRate", counters.cancelPercent())
+        .field("completedStays", counters.stays)
+        .field("averageDuration", (counters.averageStaySeconds() + 30) / 60);
+}
+
+// GET /api/analytics/zones/utilization
 static crow::response handleAnalyticsUtilization(ParkingSystem& ps) {
-    // Mock analytics based on current state
-    crow::json::wvalue x;
-    x["totalRequests"] = ps.requests.size();
-    x["successRate"] = 92;
-    x["averageDuration"] = 45;
-    return crow::response(x); // Crow auto-serializes
+    auto snapshot = ps.getSnapshot();
+    std::vector<ParkingSystem::ZoneRequestStats> zoneStats;
+    ps.getZoneRequestStats(zoneStats);
+
+    JsonWriter json;
+    json.beginObject();
+    writeRequestRates(json, ps.getRequestStats());
+    json.key("zones").beginArray();
+    for (const auto& stats : zoneStats) {
+        const ZoneSnapshot* zone = snapshot->findZone(stats.zoneId);
+        json.beginObject()
+            .field("id", stats.zoneId)
+            .field("utilization", zone != nullptr ? roundPercent(zone->occupiedSlots, zone->capacity) : 0);
+        writeRequestRates(json, stats.counters);
+        json.endObject();
+    }
+    json.endArray().endObject();
+    return jsonResponse(200, json);
 }
 
+// GET /api/analytics/cancellations
 static crow::response handleAnalyticsCancellations(ParkingSystem& ps) {
-    crow::json::wvalue x;
-    x["rate"] = 3;
-    return crow::response(x);
-}
+    RequestStats::Counters total = ps.getRequestStats();
+    std::vector<ParkingSystem::ZoneRequestStats> zoneStats;
+    ps.getZoneRequestStats(zoneStats);
 
+    JsonWriter json;
+    json.beginObject()
+        .field("rate", total.cancelPercent())
+        .field("cancelled", total.cancelled)
+        .key("zones").beginArray();
+    for (const auto& stats : zoneStats) {
+        json.beginObject()
+            .field("zoneId", stats.zoneId)
+            .field("rate", stats.counters.cancelPercent())
+            .field("cancelled", stats.counters.cancelled)
+            .endObject();
+    }
+    json.endArray().endObject();
+    return jsonResponse(200, json);
+}
 
-static crow::response handleGetDashboard(ParkingSystem& ps) {
-    int totalZones = static_cast<int>(ps.zones.size());
-    int totalSlots = 0;
-    int occupiedSlots = 0;
+// GET /api/analytics/stay-quantiles[?zones=1,2][&q=0.5,0.9,0.99]
+// Stay-duration quantiles (seconds) of the listed zones (default: all),
+// from their t-digests merged on demand; memory and cost do not grow with
+// the number of stays recorded.
+static crow::response handleAnalyticsStayQuantiles(const crow::request& req, ParkingSystem& ps) {
+    std::vector<int> zoneIds;
+    if (const char* list = req.url_params.get("zones")) {
+        for (const char* p = list; *p != '\0';) {
+            int id = 0;
+            auto parsed = std::from_chars(p, p + std::strlen(p), id);
+            if (parsed.ec != std::errc() || (*parsed.ptr != ',' && *parsed.ptr != '\0')) {
+                return crow::response(400, "zones must be a comma-separated list of ids");
+            }
+            zoneIds.push_back(id);
+            p = *parsed.ptr == ',' ? parsed.ptr + 1 : parsed.ptr;
+        }
+    }
 
-    for (const auto& zone : ps.zones) {
-        for (const auto& area : zone.parkingAreas) {
-            for (const auto& slot : area.slots) {
-                totalSlots += 1;
-                if (!slot.isAvailable) occupiedSlots += 1;
+    std::vector<double> quantiles;
+    if (const char* list = req.url_params.get("q")) {
+        for (const char* p = list; *p != '\0';) {
+            char* end = nullptr;
+            double q = std::strtod(p, &end);
+            // strtod also parses "nan" and "inf"; NaN slips past the range check.
+            if (end == p || !std::isfinite(q) || q < 0 || q > 1 || (*end != ',' && *end != '\0')) {
+                return crow::response(400, "q must be a comma-separated list in [0, 1]");
             }
+            quantiles.push_back(q);
+            p = *end == ',' ? end + 1 : end;
         }
+    } else {
+        quantiles = { 0.5, 0.9, 0.99 };
+    }
+
+    TDigest digest = ps.getStayDigest(zoneIds);
+
+    JsonWriter json;
+    json.beginObject().key("zones").beginArray();
+    for (int id : zoneIds) json.value(id);
+    json.endArray()
+        .field("stays", static_cast<long long>(digest.getCount()))
+        .key("quantiles").beginArray();
+    for (double q : quantiles) {
+        json.beginObject()
+            .field("q", q)
+            .field("seconds", static_cast<long long>(std::llround(digest.quantile(q))))
+            .endObject();
+    }
+    json.endArray();
+    if (digest.getCount() > 0) {
+        json.field("minSeconds", static_cast<long long>(digest.getMin()))
+            .field("maxSeconds", static_cast<long long>(digest.getMax()));
     }
+    json.endObject();
+    return jsonResponse(200, json);
+}
 
-    int activeRequests = 0;
-    for (const auto& req : ps.requests) {
-        if (req.currentState == ParkingRequest::State::REQUESTED ||
-            req.currentState == ParkingRequest::State::ALLOCATED) {
-            activeRequests += 1;
+static void writeUsageBucket(JsonWriter& json, const UsageSeries::Bucket& bucket) {
+    json.beginObject()
+        .field("start", bucket.start)
+        .field("peakOccupied", bucket.peakOccupied)
+        .field("requests", bucket.requests)
+        .endObject();
+}
+
+// GET /api/analytics/peak-usage[?zone=<id>][&resolution=minute|hour][&buckets=N]
+// Read straight from the per-zone ring buffers (see UsageHistory).
+// With zone: that zone's last N buckets (default 60 minutes / 24 hours)
+// and the busiest of them. Without: the busiest bucket of every zone.
+static crow::response handleAnalyticsPeakUsage(const crow::request& req, ParkingSystem& ps) {
+    long long zoneId = -1;
+    long long count = 0;
+    if (!queryInt(req, "zone", -1, zoneId) || !queryInt(req, "buckets", 0, count)) return crow::response(400);
+
+    const char* resolutionParam = req.url_params.get("resolution");
+    UsageHistory::Resolution resolution = UsageHistory::Resolution::HOUR;
+    if (resolutionParam != nullptr && std::strcmp(resolutionParam, "minute") == 0) {
+        resolution = UsageHistory::Resolution::MINUTE;
+    } else if (resolutionParam != nullptr && std::strcmp(resolutionParam, "hour") != 0) {
+        return crow::response(400, "resolution must be minute or hour");
+    }
+    if (count <= 0) count = resolution == UsageHistory::Resolution::MINUTE ? 60 : 24;
+    count = std::min<long long>(count, UsageHistory::bucketCount(resolution));
+
+    std::vector<UsageSeries::Bucket> buckets;
+    auto busiest = [&buckets]() {
+        return std::max_element(buckets.begin(), buckets.end(),
+            [](const UsageSeries::Bucket& a, const UsageSeries::Bucket& b) { return a.peakOccupied < b.peakOccupied; });
+    };
+
+    JsonWriter json;
+    json.beginObject()
+        .field("resolution", resolution == UsageHistory::Resolution::MINUTE ? "minute" : "hour")
+        .field("bucketSeconds", resolution == UsageHistory::Resolution::MINUTE ? 60 : 3600);
+
+    if (zoneId >= 0) {
+        if (!ps.getUsage(static_cast<int>(zoneId), resolution, static_cast<int>(count), buckets)) {
+            return crow::response(404);
+        }
+        json.field("zoneId", zoneId);
+        if (!buckets.empty()) {
+            json.key("peak");
+            writeUsageBucket(json, *busiest());
         }
+        json.key("buckets").beginArray();
+        for (const auto& bucket : buckets) writeUsageBucket(json, bucket);
+        json.endArray().endObject();
+        return jsonResponse(200, json);
     }
 
-    int utilization = roundPercent(occupiedSlots, totalSlots);
+    json.key("zones").beginArray();
+    for (const auto& zone : ps.getSnapshot()->zones) {
+        if (!ps.getUsage(zone->zoneId, resolution, static_cast<int>(count), buckets) || buckets.empty()) continue;
 
-    std::ostringstream out;
-    out << "{"
-        << "\"totalZones\": " << totalZones << ", "
-        << "\"occupiedSlots\": " << occupiedSlots << ", "
-        << "\"activeRequests\": " << activeRequests << ", "
-        << "\"utilization\": " << utilization
-        << "}";
+        int requests = 0;
+        for (const auto& bucket : buckets) requests += bucket.requests;
+        json.beginObject()
+            .field("zoneId", zone->zoneId)
+            .field("capacity", zone->capacity)
+            .field("requests", requests)
+            .key("peak");
+        writeUsageBucket(json, *busiest());
+        json.endObject();
+    }
+    json.endArray().endObject();
+    return jsonResponse(200, json);
+}
 
-    crow::response res(200);
-    // Use set_header to ensure Content-Type is set correctly (no duplicates)
-    res.set_header("Content-Type", "application/json; charset=utf-8");
-    res.body = out.str();
+
+static bool writeDashboard(const ParkingSnapshot& snap, JsonWriter& json) {
+    // Counters are maintained incrementally by ParkingSystem; no scan needed.
+    json.beginObject()
+        .field("totalZones", snap.zones.size())
+        .field("occupiedSlots", snap.occupiedSlots)
+        .field("activeRequests", snap.activeRequests)
+        .field("utilization", roundPercent(snap.occupiedSlots, snap.totalSlots))
+        .endObject();
+    return true;
+}
+
+static crow::response handleGetDashboard(const crow::request& req, ParkingSystem& ps, ResponseCache& cache) {
+    static const std::string key = "dashboard";
+    return cachedJson(req, ps, cache, key, writeDashboard);
+}
+
+// ------------------------------ facility tree --------------------------------
+// Campus / building / level nodes above the zones. Structural changes are
+// rare admin operations and call ParkingSystem directly (it serializes them
+// with every other mutator); they bypass the command queue.
+
+static void writeFacilitySummary(JsonWriter& json, const FacilityTree::Summary& node) {
+    json.beginObject()
+        .field("id", node.id)
+        .field("kind", node.kind)
+        .field("name", node.name)
+        .field("freeSlots", node.freeSlots)
+        .field("totalSlots", node.totalSlots);
+    if (node.zoneId >= 0) json.field("zoneId", node.zoneId);
+}
+
+// GET /api/facility/nodes/<id>: the node's counts and its children's.
+static crow::response handleGetFacilityNode(ParkingSystem& ps, int id) {
+    FacilityTree::Summary node;
+    std::vector<FacilityTree::Summary> children;
+    if (!ps.getFacilityNode(id, node, children)) return crow::response(404);
+
+    JsonWriter json;
+    writeFacilitySummary(json, node);
+    if (node.parentId >= 0) json.field("parentId", node.parentId);
+    json.key("children").beginArray();
+    for (const auto& child : children) {
+        writeFacilitySummary(json, child);
+        json.endObject();
+    }
+    json.endArray().endObject();
+    return jsonResponse(200, json);
+}
+
+// POST /api/facility/nodes {"parentId": -1, "kind": "building", "name": "B"}
+static crow::response handleCreateFacilityNode(const crow::request& req, ParkingSystem& ps) {
+    auto x = crow::json::load(req.body);
+    if (!x || !x.has("kind") || !x.has("name")) return crow::response(400);
+
+    int parentId = x.has("parentId") ? static_cast<int>(x["parentId"].i()) : -1;
+    int id = ps.addFacilityNode(parentId, x["kind"].s(), x["name"].s());
+    if (id < 0) return crow::response(400, "Unknown parent node");
+
+    JsonWriter json;
+    json.beginObject().field("id", id).endObject();
+    return jsonResponse(201, json);
+}
+
+// PUT /api/facility/nodes/<id>/zones/<zoneId>
+static crow::response handleAttachZone(ParkingSystem& ps, int nodeId, int zoneId) {
+    int id = ps.attachZoneToFacility(nodeId, zoneId);
+    if (id < 0) return crow::response(400, "Unknown node or zone, or zone already placed");
+    return handleGetFacilityNode(ps, id);
+}
+
+// GET /api/facility/nodes/<id>/free-slot: any free slot below the node that
+// a standard car may use.
+static crow::response handleFindFreeSlot(ParkingSystem& ps, int nodeId) {
+    FacilityTree::Summary node;
+    std::vector<FacilityTree::Summary> children;
+    if (!ps.getFacilityNode(nodeId, node, children)) return crow::response(404);
+
+    JsonWriter json;
+    int zoneId = -1;
+    int slotId = -1;
+    if (!ps.findFreeSlotUnder(nodeId, zoneId, slotId)) {
+        json.beginObject().field("message", "No parking slot available").endObject();
+        return jsonResponse(409, json);
+    }
+
+    json.beginObject().field("zoneId", zoneId).field("slotId", slotId).endObject();
+    return jsonResponse(200, json);
+}
+
+// GET /api/zones/<id>/price: the zone's current hourly price. The tier is
+// maintained with the occupancy counters, so this is a snapshot field read.
+static crow::response handleGetZonePrice(const crow::request& req, ParkingSystem& ps, int zoneId) {
+    std::uint64_t version = ps.getStateVersion();
+    std::string held;
+    if (notModified(req, version, held)) return notModifiedResponse(held);
+
+    auto snap = ps.getSnapshot();
+    const ZoneSnapshot* zone = snap->findZone(zoneId);
+    const ZonePrice* price = snap->findPrice(zoneId);
+    if (zone == nullptr) return crow::response(404);
+
+    JsonWriter json;
+    json.beginObject()
+        .field("zoneId", zoneId)
+        .field("priceCents", price->cents)
+        .field("tier", price->tier)
+        .field("utilization", roundPercent(zone->occupiedSlots, zone->capacity))
+        .endObject();
+    return versionedResponse(req, json, snap->version);
+}
+
+static void writePriceCurve(JsonWriter& json, const PriceCurve& curve) {
+    json.beginObject().field("basePriceCents", curve.getBasePriceCents()).key("tiers").beginArray();
+    for (const auto& tier : curve.getTiers()) {
+        json.beginObject()
+            .field("minUtilizationPercent", tier.minUtilizationPercent)
+            .field("multiplierPercent", tier.multiplierPercent)
+            .endObject();
+    }
+    json.endArray().endObject();
+}
+
+// PUT /api/pricing/curve {"basePriceCents": 300,
+//   "tiers": [{"minUtilizationPercent": 0, "multiplierPercent": 60}, ...]}
+static crow::response handleSetPriceCurve(const crow::request& req, ParkingSystem& ps) {
+    auto x = crow::json::load(req.body);
+    if (!x || !x.has("basePriceCents") || !x.has("tiers")) return crow::response(400);
+
+    std::vector<PriceCurve::Tier> tiers;
+    for (const auto& tierJson : x["tiers"]) {
+        if (!tierJson.has("minUtilizationPercent") || !tierJson.has("multiplierPercent")) return crow::response(400);
+        PriceCurve::Tier tier;
+        tier.minUtilizationPercent = static_cast<int>(tierJson["minUtilizationPercent"].i());
+        tier.multiplierPercent = static_cast<int>(tierJson["multiplierPercent"].i());
+        tiers.push_back(tier);
+    }
+
+    if (!ps.setPriceCurve(static_cast<int>(x["basePriceCents"].i()), tiers)) {
+        return crow::response(400, "tiers must start at 0%, increase, end by 100% and have positive multipliers");
+    }
+
+    JsonWriter json;
+    writePriceCurve(json, ps.getPriceCurve());
+    return jsonResponse(200, json);
+}
+
+// GET /api/zones/<id>/power: each area's charging budget and how much of
+// it current allocations hold.
+static crow::response handleGetZonePower(ParkingSystem& ps, int zoneId) {
+    std::vector<ParkingSystem::AreaPower> areas;
+    if (!ps.getZonePower(zoneId, areas)) return crow::response(404);
+
+    JsonWriter json;
+    json.beginObject().field("zoneId", zoneId).key("areas").beginArray();
+    for (const auto& area : areas) {
+        json.beginObject().field("areaId", area.areaId);
+        if (area.budgetWatts >= 0) {
+            json.field("budgetWatts", area.budgetWatts)
+                .field("reservedWatts", area.reservedWatts)
+                .field("headroomWatts", std::max(0, area.budgetWatts - area.reservedWatts));
+        }
+        json.endObject();
+    }
+    json.endArray().endObject();
+
+    crow::response res = jsonResponse(200, json);
+    res.set_header("Cache-Control", "no-store");
     return res;
 }
 
+// GET /api/zones/<id>/history?from=<t>&to=<t> (seconds since epoch; by
+// default the last 24 hours). Sampled occupancy from OccupancyArchive as
+// [time, occupied] pairs; only blocks overlapping the range are decoded.
+static crow::response handleGetZoneHistory(const crow::request& req, ParkingSystem& ps,
+                                           OccupancyArchive& archive, int zoneId) {
+    if (ps.getSnapshot()->findZone(zoneId) == nullptr) return crow::response(404);
+
+    long long to = 0;
+    long long from = 0;
+    if (!queryInt(req, "to", static_cast<long long>(std::time(nullptr)), to) ||
+        !queryInt(req, "from", std::max(0LL, to - 24 * 3600), from) || from > to) {
+        return crow::response(400);
+    }
+
+    std::vector<OccupancyArchive::Sample> samples;
+    int blocks = archive.query(zoneId, from, to, samples);
+
+    JsonWriter json;
+    json.beginObject()
+        .field("zoneId", zoneId)
+        .field("from", from)
+        .field("to", to)
+        .field("blocksDecoded", blocks)
+        .key("samples").beginArray();
+    for (const auto& sample : samples) {
+        json.beginArray().value(sample.time).value(sample.occupied).endArray();
+    }
+    json.endArray().endObject();
+    return jsonResponse(200, json);
+}
+
 // -------------------------------- main --------------------------------------
 
-int main() {
+// Crow writes a response as several sends of at most 16 buffers; with
+// Nagle on, the second waits for the peer's delayed ACK (~40 ms per
+// keep-alive request). Crow does not expose its sockets, but accepted
+// sockets inherit TCP_NODELAY from the listening one, so set it there.
+// POSIX only; a no-op elsewhere.
+static void disableNagleOnListener(unsigned short port) {
+#ifndef _WIN32
+    for (int fd = 0; fd < 1024; ++fd) {
+        int listening = 0;
+        socklen_t length = sizeof(listening);
+        if (getsockopt(fd, SOL_SOCKET, SO_ACCEPTCONN, &listening, &length) != 0 || !listening) continue;
+
+        sockaddr_storage address{};
+        length = sizeof(address);
+        if (getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) != 0) continue;
+        unsigned short bound = 0;
+        if (address.ss_family == AF_INET) bound = ntohs(reinterpret_cast<const sockaddr_in&>(address).sin_port);
+        if (address.ss_family == AF_INET6) bound = ntohs(reinterpret_cast<const sockaddr_in6&>(address).sin6_port);
+        if (bound != port) continue;
+
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+#else
+    (void)port;
+#endif
+}
+
+int main(int argc, char** argv) {
+    // --threads N: number of Crow worker threads (default: one per core).
+    // --history FILE: occupancy archive (default occupancy_history.bin).
+    // --sample-seconds N: archive sampling interval (default 60).
+    unsigned int threads = 0;
+    std::string historyPath = "occupancy_history.bin";
+    int sampleSeconds = 60;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0) threads = static_cast<unsigned int>(std::atoi(argv[i + 1]));
+        if (std::strcmp(argv[i], "--history") == 0) historyPath = argv[i + 1];
+        if (std::strcmp(argv[i], "--sample-seconds") == 0) sampleSeconds = std::max(1, std::atoi(argv[i + 1]));
+    }
+
     try {
         ParkingSystem parkingSystem;
         seedDemo(parkingSystem);
 
+        // Serialized read responses, reused until the state version changes.
+        ResponseCache responseCache;
+
+        // All mutations from HTTP handlers are applied in batches by one
+        // writer thread, pinned to the last core.
+        unsigned int cores = std::thread::hardware_concurrency();
+        CommandQueue commandQueue(parkingSystem, cores > 0 ? static_cast<int>(cores) - 1 : -1);
+        commandQueue.start();
+
+        // WS /ws/occupancy: one full snapshot on connect, then coalesced
+        // slot-level deltas broadcast once per tick to every subscriber.
+        // Declared before the app so it outlives every WebSocket connection.
+        OccupancyFeed occupancyFeed(parkingSystem, std::chrono::milliseconds(250));
+
+        // Per-zone occupancy sampled into a file of compressed blocks.
+        OccupancyArchive occupancyArchive(parkingSystem, historyPath, std::chrono::seconds(sampleSeconds));
+        if (!occupancyArchive.start()) {
+            std::cerr << "Cannot open " << historyPath << "; occupancy history disabled" << std::endl;
+        }
+
         // Use App with CORS middleware instead of SimpleApp
         // This allows us to add CORS headers to ALL responses, including automatic OPTIONS
         crow::App<CorsMiddleware> app;
@@ -375,43 +1141,87 @@ int main() {
         // GET /api/zones
         CROW_ROUTE(app, "/api/zones")
         .methods(crow::HTTPMethod::GET)
-        ([&parkingSystem](const crow::request&) {
-            return handleGetZones(parkingSystem);
+        ([&parkingSystem, &responseCache](const crow::request& req) {
+            return handleGetZones(req, parkingSystem, responseCache);
         });
         
         // POST /api/zones
         CROW_ROUTE(app, "/api/zones")
         .methods(crow::HTTPMethod::POST)
-        ([&parkingSystem](const crow::request& req) {
-            return handleCreateZone(req, parkingSystem);
+        ([&parkingSystem, &commandQueue](const crow::request& req, crow::response& res) {
+            spawnHandler(req, res, handleCreateZone(req, parkingSystem, commandQueue));
         });
         
         // GET /api/zones/<int>
         CROW_ROUTE(app, "/api/zones/<int>")
         .methods(crow::HTTPMethod::GET)
+        ([&parkingSystem, &responseCache](const crow::request& req, int id) {
+            return handleGetZoneDetail(req, parkingSystem, responseCache, id);
+        });
+
+        // GET /api/zones/<int>/wait?timeout=<ms> (long-poll coroutine)
+        CROW_ROUTE(app, "/api/zones/<int>/wait")
+        .methods(crow::HTTPMethod::GET)
+        ([&parkingSystem](const crow::request& req, crow::response& res, int id) {
+            spawnHandler(req, res, handleWaitForSlot(req, parkingSystem, id));
+        });
+
+        // GET /api/zones/<int>/price
+        CROW_ROUTE(app, "/api/zones/<int>/price")
+        .methods(crow::HTTPMethod::GET)
+        ([&parkingSystem](const crow::request& req, int id) {
+            return handleGetZonePrice(req, parkingSystem, id);
+        });
+
+        // GET /api/pricing/curve
+        CROW_ROUTE(app, "/api/pricing/curve")
+        .methods(crow::HTTPMethod::GET)
+        ([&parkingSystem]() {
+            JsonWriter json;
+            writePriceCurve(json, parkingSystem.getPriceCurve());
+            return jsonResponse(200, json);
+        });
+
+        // PUT /api/pricing/curve
+        CROW_ROUTE(app, "/api/pricing/curve")
+        .methods(crow::HTTPMethod::PUT)
+        ([&parkingSystem](const crow::request& req) {
+            return handleSetPriceCurve(req, parkingSystem);
+        });
+
+        // GET /api/zones/<int>/power
+        CROW_ROUTE(app, "/api/zones/<int>/power")
+        .methods(crow::HTTPMethod::GET)
         ([&parkingSystem](int id) {
-            return handleGetZoneDetail(parkingSystem, id);
+            return handleGetZonePower(parkingSystem, id);
+        });
+
+        // GET /api/zones/<int>/history
+        CROW_ROUTE(app, "/api/zones/<int>/history")
+        .methods(crow::HTTPMethod::GET)
+        ([&parkingSystem, &occupancyArchive](const crow::request& req, int id) {
+            return handleGetZoneHistory(req, parkingSystem, occupancyArchive, id);
         });
 
         // GET /api/dashboard
         CROW_ROUTE(app, "/api/dashboard")
         .methods(crow::HTTPMethod::GET)
-        ([&parkingSystem](const crow::request&) {
-            return handleGetDashboard(parkingSystem);
+        ([&parkingSystem, &responseCache](const crow::request& req) {
+            return handleGetDashboard(req, parkingSystem, responseCache);
         });
         
         // GET /api/parking/requests
         CROW_ROUTE(app, "/api/parking/requests")
         .methods(crow::HTTPMethod::GET)
-        ([&parkingSystem](const crow::request&) {
-            return handleGetRequests(parkingSystem);
+        ([&parkingSystem, &responseCache](const crow::request& req) {
+            return handleGetRequests(req, parkingSystem, responseCache);
         });
         
         // POST /api/parking/requests
         CROW_ROUTE(app, "/api/parking/requests")
         .methods(crow::HTTPMethod::POST)
-        ([&parkingSystem](const crow::request& req) {
-            return handleCreateRequest(req, parkingSystem);
+        ([&commandQueue](const crow::request& req, crow::response& res) {
+            spawnHandler(req, res, handleCreateRequest(req, commandQueue));
         });
 
         // PUT /api/parking/requests/<int>/allocate
@@ -420,7 +1230,56 @@ int main() {
         ([&parkingSystem](const crow::request& req, int id) {
             return handleAllocateRequest(req, id, parkingSystem);
         });
+
+        // PUT /api/parking/requests/<int>/occupy
+        CROW_ROUTE(app, "/api/parking/requests/<int>/occupy")
+        .methods(crow::HTTPMethod::PUT)
+        ([&parkingSystem, &commandQueue](const crow::request& req, crow::response& res, int id) {
+            spawnHandler(req, res, finishRequest(id, parkingSystem, commandQueue, CommandQueue::Command::OCCUPY_SLOT));
+        });
+
+        // PUT /api/parking/requests/<int>/cancel
+        CROW_ROUTE(app, "/api/parking/requests/<int>/cancel")
+        .methods(crow::HTTPMethod::PUT)
+        ([&parkingSystem, &commandQueue](const crow::request& req, crow::response& res, int id) {
+            spawnHandler(req, res, finishRequest(id, parkingSystem, commandQueue, CommandQueue::Command::CANCEL_REQUEST));
+        });
+
+        // PUT /api/parking/requests/<int>/release
+        CROW_ROUTE(app, "/api/parking/requests/<int>/release")
+        .methods(crow::HTTPMethod::PUT)
+        ([&parkingSystem, &commandQueue](const crow::request& req, crow::response& res, int id) {
+            spawnHandler(req, res, finishRequest(id, parkingSystem, commandQueue, CommandQueue::Command::RELEASE_SLOT));
+        });
         
+        // GET /api/facility/nodes/<int>
+        CROW_ROUTE(app, "/api/facility/nodes/<int>")
+        .methods(crow::HTTPMethod::GET)
+        ([&parkingSystem](int id) {
+            return handleGetFacilityNode(parkingSystem, id);
+        });
+
+        // POST /api/facility/nodes
+        CROW_ROUTE(app, "/api/facility/nodes")
+        .methods(crow::HTTPMethod::POST)
+        ([&parkingSystem](const crow::request& req) {
+            return handleCreateFacilityNode(req, parkingSystem);
+        });
+
+        // PUT /api/facility/nodes/<int>/zones/<int>
+        CROW_ROUTE(app, "/api/facility/nodes/<int>/zones/<int>")
+        .methods(crow::HTTPMethod::PUT)
+        ([&parkingSystem](int id, int zoneId) {
+            return handleAttachZone(parkingSystem, id, zoneId);
+        });
+
+        // GET /api/facility/nodes/<int>/free-slot
+        CROW_ROUTE(app, "/api/facility/nodes/<int>/free-slot")
+        .methods(crow::HTTPMethod::GET)
+        ([&parkingSystem](int id) {
+            return handleFindFreeSlot(parkingSystem, id);
+        });
+
         // GET /api/analytics/zones/utilization
         CROW_ROUTE(app, "/api/analytics/zones/utilization")
         .methods(crow::HTTPMethod::GET)
@@ -435,11 +1294,69 @@ int main() {
             return handleAnalyticsCancellations(parkingSystem);
         });
 
+        // GET /api/analytics/stay-quantiles
+        CROW_ROUTE(app, "/api/analytics/stay-quantiles")
+        .methods(crow::HTTPMethod::GET)
+        ([&parkingSystem](const crow::request& req) {
+            return handleAnalyticsStayQuantiles(req, parkingSystem);
+        });
+
+        // GET /api/analytics/peak-usage
+        CROW_ROUTE(app, "/api/analytics/peak-usage")
+        .methods(crow::HTTPMethod::GET)
+        ([&parkingSystem](const crow::request& req) {
+            return handleAnalyticsPeakUsage(req, parkingSystem);
+        });
+
+        CROW_WEBSOCKET_ROUTE(app, "/ws/occupancy")
+        .onopen([&occupancyFeed](crow::websocket::connection& conn) {
+            occupancyFeed.subscribe(conn);
+        })
+        .onclose([&occupancyFeed](crow::websocket::connection& conn, const std::string&, uint16_t) {
+            occupancyFeed.unsubscribe(conn);
+        })
+        .onerror([&occupancyFeed](crow::websocket::connection& conn, const std::string&) {
+            occupancyFeed.unsubscribe(conn);
+        });
+        occupancyFeed.start();
+
+        // Streaming endpoints (chunked export, SSE) live on a separate asio listener.
+        StreamServer streamServer(parkingSystem, 8081);
+        streamServer.start();
+
+        // Gate controllers speak the binary protocol in GateProtocol.h.
+        GateServer gateServer(parkingSystem, commandQueue, 9090);
+        gateServer.start();
+
+        // Ground sensors report arrivals / departures over UDP.
+        SensorListener sensorListener(commandQueue, 9091);
+        sensorListener.start();
+
         std::cout << "Server started at http://localhost:8080" << std::endl;
         std::cout << "Endpoints:" << std::endl;
         std::cout << "  GET  /api/zones" << std::endl;
+        std::cout << "  GET  /api/zones/<id>/wait?timeout=" << std::endl;
+        std::cout << "  GET  /api/zones/<id>/history?from=&to=" << std::endl;
         std::cout << "  GET  /api/dashboard" << std::endl;
-        app.port(8080).multithreaded().run();
+        std::cout << "  GET  /api/facility/nodes/<id>[/free-slot]" << std::endl;
+        std::cout << "  GET  /api/parking/requests?limit=&cursor=" << std::endl;
+        std::cout << "  WS   /ws/occupancy" << std::endl;
+        std::cout << "Streaming at http://localhost:8081" << std::endl;
+        std::cout << "  GET  /api/parking/requests/export (chunked)" << std::endl;
+        std::cout << "  GET  /api/events/free-slots (server-sent events)" << std::endl;
+        std::cout << "Gate protocol (binary) at tcp://localhost:9090" << std::endl;
+        std::cout << "Slot sensors (binary) at udp://localhost:9091" << std::endl;
+        auto serving = threads > 0 ? app.port(8080).concurrency(threads).run_async()
+                                   : app.port(8080).multithreaded().run_async();
+        app.wait_for_server_start();
+        disableNagleOnListener(8080);
+        serving.wait();
+        sensorListener.stop();
+        gateServer.stop();
+        streamServer.stop();
+        occupancyFeed.stop();
+        occupancyArchive.stop();
+        commandQueue.stop();
         return 0;
     } catch (const std::exception& e) {
         std::cerr << "FATAL ERROR: " << e.what() << std::endl;
@@ -0,0 +1,58 @@
+#include "SlotWaiters.h"
+
+#include <utility>
+
+SlotWaiters::SlotWaiters()
+    : nextToken(1)
+{
+}
+
+std::uint64_t SlotWaiters::add(int zoneId, Callback wake)
+{
+    std::uint64_t token = nextToken++;
+    byZone[zoneId].push_back(Waiter{ token, std::move(wake) });
+    return token;
+}
+
+bool SlotWaiters::remove(int zoneId, std::uint64_t token)
+{
+    auto it = byZone.find(zoneId);
+    if (it == byZone.end())
+    {
+        return false;
+    }
+
+    auto& queue = it->second;
+    for (auto waiter = queue.begin(); waiter != queue.end(); ++waiter)
+    {
+        if (waiter->token == token)
+        {
+            queue.erase(waiter);
+            if (queue.empty())
+            {
+                byZone.erase(it);
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void SlotWaiters::wakeOne(int zoneId)
+{
+    auto it = byZone.find(zoneId);
+    if (it == byZone.end())
+    {
+        return;
+    }
+
+    Callback wake = std::move(it->second.front().wake);
+    it->second.pop_front();
+    if (it->second.empty())
+    {
+        byZone.erase(it);
+    }
+
+    wake();
+}
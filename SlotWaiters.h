@@ -0,0 +1,40 @@
+#ifndef SLOT_WAITERS_H
+#define SLOT_WAITERS_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+
+// FIFO of callbacks per zone, woken one at a time as slots free up.
+// Not synchronized; ParkingSystem guards it with its own lock.
+class SlotWaiters
+{
+public:
+    using Callback = std::function<void()>;
+
+private:
+    struct Waiter
+    {
+        std::uint64_t token;
+        Callback wake;
+    };
+
+    std::unordered_map<int, std::deque<Waiter>> byZone;
+    std::uint64_t nextToken;
+
+public:
+    SlotWaiters();
+
+    // Queues a waiter and returns its token (never 0).
+    std::uint64_t add(int zoneId, Callback wake);
+
+    // Removes a waiter that has not been woken yet.
+    // Returns false if it was already woken (or never existed).
+    bool remove(int zoneId, std::uint64_t token);
+
+    // Dequeues and runs the oldest waiter for the zone, if any.
+    void wakeOne(int zoneId);
+};
+
+#endif  // SLOT_WAITERS_H
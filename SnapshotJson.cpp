@@ -0,0 +1,27 @@
+#include "SnapshotJson.h"
+
+void writeRequestRecord(JsonWriter& json, const RequestRecord& req)
+{
+    json.beginObject()
+        .field("id", req.requestId)
+        .field("vehicleId", req.vehicleId)
+        .field("zoneId", req.allocatedZoneId)
+        .field("slotNumber", req.allocatedSlotId);
+    if (req.slotCount > 1)
+    {
+        // Multi-slot requests hold slotNumber and the slots after it.
+        json.field("slotCount", req.slotCount);
+    }
+    if (req.slotType != static_cast<int>(ParkingSlot::Type::STANDARD))
+    {
+        json.field("slotType", ParkingSlot::typeToString(static_cast<ParkingSlot::Type>(req.slotType)));
+    }
+    if (req.chargeWatts > 0)
+    {
+        json.field("chargeWatts", req.chargeWatts);
+    }
+    json.field("status", ParkingRequest::stateToString(req.state))
+        .field("requestTime", req.requestTime)
+        .field("timestamp", "Recently")
+        .endObject();
+}
@@ -0,0 +1,16 @@
+#ifndef SNAPSHOT_JSON_H
+#define SNAPSHOT_JSON_H
+
+#include "JsonWriter.h"
+#include "ParkingSlot.h"
+#include "ParkingSnapshot.h"
+
+// JSON shapes shared by every endpoint that serializes snapshot records
+// (Crow handlers and the streaming listener), so they cannot drift apart.
+
+// {"id":..,"vehicleId":..,"zoneId":..,"slotNumber":..,"status":..,
+//  "requestTime":..,"timestamp":..}, plus "slotCount" above 1 and
+// "slotType" for non-standard bays and "chargeWatts" while charging.
+void writeRequestRecord(JsonWriter& json, const RequestRecord& req);
+
+#endif  // SNAPSHOT_JSON_H
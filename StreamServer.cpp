@@ -0,0 +1,478 @@
+#include "StreamServer.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "JsonWriter.h"
+#include "ParkingSnapshot.h"
+#include "ParkingSystem.h"
+#include "SnapshotJson.h"
+
+// One accepted socket. Reads a single request head, dispatches it, and
+// closes the connection when the response is complete (or, for an event
+// stream, when the client goes away).
+class StreamServer::Connection : public std::enable_shared_from_this<StreamServer::Connection>
+{
+private:
+    StreamServer& server;
+    asio::ip::tcp::socket socket;
+    asio::streambuf requestBuffer;
+
+    // Export state
+    std::shared_ptr<const ParkingSnapshot> snapshot;
+    int nextRequest;
+    std::string head;
+    std::string body;
+    std::string tail;
+
+    // Event stream state
+    std::deque<std::shared_ptr<const std::string>> outbox;
+    bool writing;
+    bool closed;
+
+public:
+    Connection(StreamServer& server, asio::ip::tcp::socket socket)
+        : server(server), socket(std::move(socket)), nextRequest(0), writing(false), closed(false)
+    {
+    }
+
+    void start()
+    {
+        auto self = shared_from_this();
+        asio::async_read_until(socket, requestBuffer, "\r\n\r\n",
+            [self](const asio::error_code& ec, std::size_t)
+            {
+                if (!ec)
+                {
+                    self->dispatch();
+                }
+            });
+    }
+
+private:
+    static void appendCommonHeaders(std::string& out)
+    {
+        out += "Access-Control-Allow-Origin: *\r\n";
+        out += "Cache-Control: no-cache\r\n";
+        out += "Connection: close\r\n";
+    }
+
+    void dispatch()
+    {
+        std::istream in(&requestBuffer);
+        std::string method, target;
+        in >> method >> target;
+
+        std::string path = target.substr(0, target.find('?'));
+
+        if (method == "GET" && path == "/api/parking/requests/export")
+        {
+            startExport();
+            return;
+        }
+
+        if (method == "GET" && path == "/api/events/free-slots")
+        {
+            startEventStream(readLastEventId(in));
+            return;
+        }
+
+        if (method == "OPTIONS")
+        {
+            head = "HTTP/1.1 204 No Content\r\n";
+            appendCommonHeaders(head);
+            head += "Access-Control-Allow-Methods: GET, OPTIONS\r\n\r\n";
+            writeAndClose();
+            return;
+        }
+
+        head = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n";
+        appendCommonHeaders(head);
+        head += "\r\n";
+        writeAndClose();
+    }
+
+    void writeAndClose()
+    {
+        auto self = shared_from_this();
+        asio::async_write(socket, asio::buffer(head),
+            [self](const asio::error_code&, std::size_t)
+            {
+                asio::error_code ignored;
+                self->socket.shutdown(asio::ip::tcp::socket::shutdown_both, ignored);
+            });
+    }
+
+    // Scans the remaining header lines for Last-Event-ID (0 when absent).
+    static std::uint64_t readLastEventId(std::istream& in)
+    {
+        static const char NAME[] = "last-event-id:";
+        const std::size_t nameLength = sizeof(NAME) - 1;
+
+        std::string line;
+        while (std::getline(in, line) && line != "\r")
+        {
+            if (line.size() <= nameLength)
+            {
+                continue;
+            }
+
+            bool match = true;
+            for (std::size_t i = 0; i < nameLength && match; ++i)
+            {
+                match = std::tolower(static_cast<unsigned char>(line[i])) == NAME[i];
+            }
+
+            if (match)
+            {
+                return std::strtoull(line.c_str() + nameLength, nullptr, 10);
+            }
+        }
+        return 0;
+    }
+
+    // ---- GET /api/events/free-slots ----
+
+    void startEventStream(std::uint64_t lastEventId)
+    {
+        std::string first = "HTTP/1.1 200 OK\r\n"
+                            "Content-Type: text/event-stream\r\n"
+                            "Access-Control-Allow-Origin: *\r\n"
+                            "Cache-Control: no-cache\r\n"
+                            "X-Accel-Buffering: no\r\n"
+                            "\r\n"
+                            "retry: 3000\n\n";
+
+        std::vector<FreeCountBoard::Event> missed;
+        server.freeCounts.missedSince(lastEventId, missed);
+        for (const auto& event : missed)
+        {
+            appendFreeEvent(first, event);
+        }
+        auto snapshot = server.system.getSnapshot();
+        for (std::size_t i = 0; i < snapshot->zones.size(); ++i)
+        {
+            appendPriceEvent(first, snapshot->zones[i]->zoneId, snapshot->prices[i]);
+        }
+
+        send(std::make_shared<const std::string>(std::move(first)));
+        server.subscribers.push_back(shared_from_this());
+        watchForClose();
+    }
+
+    // Clients never send anything after the request head, so any read
+    // completion means EOF or an error.
+    void watchForClose()
+    {
+        auto self = shared_from_this();
+        asio::async_read(socket, requestBuffer, asio::transfer_at_least(1),
+            [self](const asio::error_code& ec, std::size_t)
+            {
+                if (ec)
+                {
+                    self->close();
+                }
+                else
+                {
+                    self->requestBuffer.consume(self->requestBuffer.size());
+                    self->watchForClose();
+                }
+            });
+    }
+
+    void close()
+    {
+        if (closed)
+        {
+            return;
+        }
+        closed = true;
+        outbox.clear();
+        asio::error_code ignored;
+        socket.shutdown(asio::ip::tcp::socket::shutdown_both, ignored);
+        socket.close(ignored);
+    }
+
+    void writeOutbox()
+    {
+        writing = true;
+        auto self = shared_from_this();
+        asio::async_write(socket, asio::buffer(*outbox.front()),
+            [self](const asio::error_code& ec, std::size_t)
+            {
+                self->writing = false;
+                if (ec || self->closed)
+                {
+                    self->close();
+                    return;
+                }
+
+                self->outbox.pop_front();
+                if (!self->outbox.empty())
+                {
+                    self->writeOutbox();
+                }
+            });
+    }
+
+public:
+    bool isOpen() const
+    {
+        return !closed;
+    }
+
+    // Queues a message shared with every other subscriber. A client that
+    // falls too far behind is disconnected rather than buffered forever.
+    void send(const std::shared_ptr<const std::string>& message)
+    {
+        if (closed)
+        {
+            return;
+        }
+
+        if (outbox.size() >= MAX_PENDING_MESSAGES)
+        {
+            close();
+            return;
+        }
+
+        outbox.push_back(message);
+        if (!writing)
+        {
+            writeOutbox();
+        }
+    }
+
+private:
+    // ---- GET /api/parking/requests/export ----
+
+    void startExport()
+    {
+        // Pin one consistent view for the whole export; writers keep going.
+        snapshot = server.system.getSnapshot();
+        nextRequest = 0;
+
+        head = "HTTP/1.1 200 OK\r\n"
+               "Content-Type: application/json; charset=utf-8\r\n"
+               "Transfer-Encoding: chunked\r\n";
+        appendCommonHeaders(head);
+        head += "\r\n";
+
+        writeNextChunk(true);
+    }
+
+    // Serializes records until roughly CHUNK_BYTES are buffered, frames them
+    // as one HTTP chunk and writes it. Only one chunk is ever held in memory.
+    void writeNextChunk(bool first)
+    {
+        body.clear();
+        if (first)
+        {
+            body += "{\"requests\":[";
+        }
+        else if (nextRequest > 0 && nextRequest < snapshot->requestCount)
+        {
+            body.push_back(',');
+        }
+
+        JsonWriter json(body);
+        while (nextRequest < snapshot->requestCount && body.size() < CHUNK_BYTES)
+        {
+            writeRequestRecord(json, snapshot->getRequest(nextRequest++));
+        }
+
+        bool last = nextRequest >= snapshot->requestCount;
+        if (last)
+        {
+            body += "]}";
+        }
+
+        char size[20];
+        int len = std::snprintf(size, sizeof(size), "%zx\r\n", body.size());
+        if (!first)
+        {
+            head.clear();
+        }
+        head.append(size, static_cast<std::size_t>(len));
+        tail = last ? "\r\n0\r\n\r\n" : "\r\n";
+
+        std::vector<asio::const_buffer> buffers;
+        buffers.push_back(asio::buffer(head));
+        buffers.push_back(asio::buffer(body));
+        buffers.push_back(asio::buffer(tail));
+
+        auto self = shared_from_this();
+        asio::async_write(socket, buffers,
+            [self, last](const asio::error_code& ec, std::size_t)
+            {
+                if (ec)
+                {
+                    return;  // client went away; dropping self closes the socket
+                }
+
+                if (last)
+                {
+                    asio::error_code ignored;
+                    self->socket.shutdown(asio::ip::tcp::socket::shutdown_both, ignored);
+                    return;
+                }
+
+                self->writeNextChunk(false);
+            });
+    }
+};
+
+StreamServer::StreamServer(ParkingSystem& system, unsigned short port)
+    : system(system),
+      acceptor(io, asio::ip::tcp::endpoint(asio::ip::tcp::v4(), port)),
+      freeCounts(FREE_EVENT_INTERVAL),
+      ticker(io),
+      ticksSinceKeepAlive(0)
+{
+}
+
+StreamServer::~StreamServer()
+{
+    stop();
+}
+
+void StreamServer::start()
+{
+    accept();
+    tick();
+    worker = std::thread([this]()
+    {
+        try
+        {
+            io.run();
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "StreamServer error: " << e.what() << std::endl;
+        }
+    });
+}
+
+void StreamServer::stop()
+{
+    io.stop();
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+void StreamServer::accept()
+{
+    acceptor.async_accept(
+        [this](const asio::error_code& ec, asio::ip::tcp::socket socket)
+        {
+            if (!ec)
+            {
+                std::make_shared<Connection>(*this, std::move(socket))->start();
+            }
+
+            if (acceptor.is_open())
+            {
+                accept();
+            }
+        });
+}
+
+void StreamServer::scheduleTick()
+{
+    ticker.expires_after(TICK_INTERVAL);
+    ticker.async_wait([this](const asio::error_code& ec)
+    {
+        if (!ec)
+        {
+            tick();
+        }
+    });
+}
+
+void StreamServer::tick()
+{
+    std::shared_ptr<const ParkingSnapshot> snapshot = system.getSnapshot();
+    dueEvents.clear();
+    freeCounts.update(*snapshot, FreeCountBoard::Clock::now(), dueEvents);
+
+    std::string message;
+    for (const auto& event : dueEvents)
+    {
+        appendFreeEvent(message, event);
+    }
+    appendPriceChanges(message, *snapshot);
+
+    if (!message.empty())
+    {
+        broadcast(std::make_shared<const std::string>(std::move(message)));
+        ticksSinceKeepAlive = 0;
+    }
+    else if (++ticksSinceKeepAlive >= KEEPALIVE_TICKS)
+    {
+        static const auto keepAlive = std::make_shared<const std::string>(": keepalive\n\n");
+        broadcast(keepAlive);
+        ticksSinceKeepAlive = 0;
+    }
+
+    scheduleTick();
+}
+
+void StreamServer::broadcast(const std::shared_ptr<const std::string>& message)
+{
+    // Sends to live subscribers and compacts out the closed ones in one pass.
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < subscribers.size(); ++i)
+    {
+        auto connection = subscribers[i].lock();
+        if (!connection || !connection->isOpen())
+        {
+            continue;
+        }
+
+        connection->send(message);
+        if (kept != i)
+        {
+            subscribers[kept] = std::move(subscribers[i]);
+        }
+        ++kept;
+    }
+    subscribers.resize(kept);
+}
+
+void StreamServer::appendPriceChanges(std::string& out, const ParkingSnapshot& snapshot)
+{
+    sentPrices.resize(snapshot.zones.size(), -1);
+    for (std::size_t i = 0; i < snapshot.zones.size(); ++i)
+    {
+        const ZonePrice& price = snapshot.prices[i];
+        if (price.cents != sentPrices[i])
+        {
+            appendPriceEvent(out, snapshot.zones[i]->zoneId, price);
+            sentPrices[i] = price.cents;
+        }
+    }
+}
+
+void StreamServer::appendPriceEvent(std::string& out, int zoneId, const ZonePrice& price)
+{
+    char line[112];
+    int len = std::snprintf(line, sizeof(line),
+                            "event: price\ndata: {\"zoneId\":%d,\"priceCents\":%d,\"tier\":%d}\n\n",
+                            zoneId, price.cents, price.tier);
+    out.append(line, static_cast<std::size_t>(len));
+}
+
+void StreamServer::appendFreeEvent(std::string& out, const FreeCountBoard::Event& event)
+{
+    char line[96];
+    int len = std::snprintf(line, sizeof(line),
+                            "id: %llu\nevent: free\ndata: {\"zoneId\":%d,\"freeSlots\":%d}\n\n",
+                            static_cast<unsigned long long>(event.id), event.zoneId, event.freeSlots);
+    out.append(line, static_cast<std::size_t>(len));
+}
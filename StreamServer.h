@@ -0,0 +1,97 @@
+#ifndef STREAM_SERVER_H
+#define STREAM_SERVER_H
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef ASIO_STANDALONE
+#define ASIO_STANDALONE
+#endif
+#include <asio.hpp>
+
+#include "FreeCountBoard.h"
+
+class ParkingSystem;
+
+// Minimal asio HTTP/1.1 listener for long-lived or streamed responses that
+// Crow's request/response model cannot express (it always materializes the
+// whole body before writing).
+//
+// Routes:
+//   GET /api/parking/requests/export
+//       Every request as one JSON document, sent with
+//       Transfer-Encoding: chunked. Rendered from a single immutable
+//       snapshot, a bounded number of bytes at a time, so memory use does
+//       not grow with the number of requests.
+//
+//   GET /api/events/free-slots
+//       Server-Sent Events for display boards: one "free" event per zone
+//       whose free-slot count changed, at most one per zone per
+//       FREE_EVENT_INTERVAL. Honours Last-Event-ID on reconnect.
+//       Idle subscribers cost no timers or threads: a single ticker diffs
+//       the snapshot and formats each event once for everyone.
+//       The same stream carries a "price" event per zone whose price
+//       changed (i.e. crossed a PriceCurve breakpoint), and the current
+//       price of every zone on connect. Price events have no id.
+//
+// Runs on its own io_context and thread, alongside the Crow app.
+class StreamServer
+{
+public:
+    // Upper bound on the payload of a single HTTP chunk.
+    static const std::size_t CHUNK_BYTES = 16 * 1024;
+
+    // How often the snapshot is checked for free-count changes.
+    static constexpr std::chrono::milliseconds TICK_INTERVAL{ 200 };
+
+    // Minimum spacing between two events for the same zone.
+    static constexpr std::chrono::milliseconds FREE_EVENT_INTERVAL{ 1000 };
+
+    // Comment line sent to idle streams so proxies keep them open.
+    static const int KEEPALIVE_TICKS = 75;  // 15 s
+
+    // Subscribers with this many unsent messages are dropped.
+    static const std::size_t MAX_PENDING_MESSAGES = 64;
+
+    StreamServer(ParkingSystem& system, unsigned short port);
+    ~StreamServer();
+
+    StreamServer(const StreamServer&) = delete;
+    StreamServer& operator=(const StreamServer&) = delete;
+
+    void start();
+    void stop();
+
+private:
+    class Connection;
+
+    ParkingSystem& system;
+    asio::io_context io;
+    asio::ip::tcp::acceptor acceptor;
+    std::thread worker;
+
+    // SSE state; only touched on the io thread.
+    FreeCountBoard freeCounts;
+    asio::steady_timer ticker;
+    std::vector<std::weak_ptr<Connection>> subscribers;
+    std::vector<FreeCountBoard::Event> dueEvents;
+    std::vector<int> sentPrices;  // by zone position, -1 before the first
+    int ticksSinceKeepAlive;
+
+    void accept();
+    void scheduleTick();
+    void tick();
+    void broadcast(const std::shared_ptr<const std::string>& message);
+
+    // Price events for zones whose price differs from sentPrices, which it
+    // then updates.
+    void appendPriceChanges(std::string& out, const ParkingSnapshot& snapshot);
+
+    static void appendFreeEvent(std::string& out, const FreeCountBoard::Event& event);
+    static void appendPriceEvent(std::string& out, int zoneId, const ZonePrice& price);
+};
+
+#endif  // STREAM_SERVER_H
@@ -0,0 +1,176 @@
+#include "TDigest.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const double PI = 3.14159265358979323846;
+
+    // k1 scale: q -> k and back. A centroid may span at most 1 in k.
+    double scale(double q)
+    {
+        return TDigest::COMPRESSION / (2 * PI) * std::asin(2 * q - 1);
+    }
+
+    double inverseScale(double k)
+    {
+        if (k >= TDigest::COMPRESSION / 4.0)
+        {
+            return 1;
+        }
+        return (std::sin(k * 2 * PI / TDigest::COMPRESSION) + 1) / 2;
+    }
+}
+
+TDigest::TDigest()
+    : totalWeight(0), min(0), max(0)
+{
+}
+
+void TDigest::add(double value)
+{
+    push(Centroid{ value, 1 });
+}
+
+void TDigest::push(const Centroid& centroid)
+{
+    if (totalWeight == 0)
+    {
+        min = centroid.mean;
+        max = centroid.mean;
+    }
+    min = std::min(min, centroid.mean);
+    max = std::max(max, centroid.mean);
+    totalWeight += centroid.weight;
+
+    buffer.push_back(centroid);
+    if (buffer.size() >= BUFFER_SIZE)
+    {
+        compress();
+    }
+}
+
+void TDigest::merge(const TDigest& other)
+{
+    if (other.totalWeight == 0)
+    {
+        return;
+    }
+
+    for (const Centroid& centroid : other.centroids)
+    {
+        push(centroid);
+    }
+    for (const Centroid& centroid : other.buffer)
+    {
+        push(centroid);
+    }
+
+    // push() only saw centroid means; once other has compressed, its
+    // extremes sit inside its outer centroids.
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+}
+
+void TDigest::compress()
+{
+    if (buffer.empty())
+    {
+        return;
+    }
+
+    buffer.insert(buffer.end(), centroids.begin(), centroids.end());
+    std::sort(buffer.begin(), buffer.end(),
+              [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+
+    // One left-to-right pass: keep folding neighbours into the current
+    // centroid while its span of the quantile range stays within the
+    // limit the scale function allows at that point.
+    centroids.clear();
+    Centroid current = buffer.front();
+    double weightBefore = 0;
+    double limit = totalWeight * inverseScale(scale(0) + 1);
+
+    for (std::size_t i = 1; i < buffer.size(); ++i)
+    {
+        const Centroid& next = buffer[i];
+        if (weightBefore + current.weight + next.weight <= limit)
+        {
+            current.weight += next.weight;
+            current.mean += (next.mean - current.mean) * next.weight / current.weight;
+            continue;
+        }
+
+        centroids.push_back(current);
+        weightBefore += current.weight;
+        limit = totalWeight * inverseScale(scale(weightBefore / totalWeight) + 1);
+        current = next;
+    }
+    centroids.push_back(current);
+
+    buffer.clear();
+}
+
+double TDigest::quantile(double q)
+{
+    compress();
+    if (centroids.empty())
+    {
+        return 0;
+    }
+    if (centroids.size() == 1)
+    {
+        return centroids.front().mean;
+    }
+
+    q = std::max(0.0, std::min(1.0, q));
+    double index = q * totalWeight;
+
+    // Below the first centroid's centre / above the last one's: interpolate
+    // towards the exact min / max.
+    const Centroid& first = centroids.front();
+    if (index < first.weight / 2)
+    {
+        return min + (first.mean - min) * index / (first.weight / 2);
+    }
+
+    const Centroid& last = centroids.back();
+    if (index > totalWeight - last.weight / 2)
+    {
+        return max - (max - last.mean) * (totalWeight - index) / (last.weight / 2);
+    }
+
+    // Between two centroid centres.
+    double centre = first.weight / 2;
+    for (std::size_t i = 0; i + 1 < centroids.size(); ++i)
+    {
+        double gap = (centroids[i].weight + centroids[i + 1].weight) / 2;
+        if (index <= centre + gap)
+        {
+            return centroids[i].mean + (centroids[i + 1].mean - centroids[i].mean) * (index - centre) / gap;
+        }
+        centre += gap;
+    }
+    return last.mean;
+}
+
+double TDigest::getCount() const
+{
+    return totalWeight;
+}
+
+double TDigest::getMin() const
+{
+    return min;
+}
+
+double TDigest::getMax() const
+{
+    return max;
+}
+
+std::size_t TDigest::getCentroidCount() const
+{
+    return centroids.size() + buffer.size();
+}
@@ -0,0 +1,56 @@
+#ifndef T_DIGEST_H
+#define T_DIGEST_H
+
+#include <cstddef>
+#include <vector>
+
+// Mergeable quantile sketch (Dunning's merging t-digest).
+//
+// Values are summarized as weighted centroids. Centroids near the median
+// may absorb many values; those near the tails stay small (k1 scale
+// function), so p99 stays accurate. New values are buffered and folded in
+// by compress() once BUFFER_SIZE accumulate, so add() is O(1) amortized
+// and memory stays at roughly COMPRESSION / 2 centroids plus the buffer,
+// however many values were added. Two digests combine with
+// merge(), which is how per-zone digests are queried together.
+//
+// Not synchronized.
+class TDigest
+{
+public:
+    static const int COMPRESSION = 200;
+    static const std::size_t BUFFER_SIZE = 5 * COMPRESSION;
+
+    TDigest();
+
+    void add(double value);
+
+    // Adds everything other summarizes.
+    void merge(const TDigest& other);
+
+    // Estimated value at quantile q (clamped to [0, 1]); 0 when empty.
+    double quantile(double q);
+
+    double getCount() const;
+    double getMin() const;
+    double getMax() const;
+    std::size_t getCentroidCount() const;
+
+private:
+    struct Centroid
+    {
+        double mean;
+        double weight;
+    };
+
+    std::vector<Centroid> centroids;  // sorted by mean after compress()
+    std::vector<Centroid> buffer;     // unmerged, in arrival order
+    double totalWeight;
+    double min;
+    double max;
+
+    void push(const Centroid& centroid);
+    void compress();
+};
+
+#endif  // T_DIGEST_H
@@ -0,0 +1,130 @@
+#include "UsageHistory.h"
+
+#include <algorithm>
+
+UsageSeries::UsageSeries(int widthSeconds, int bucketCount)
+    : widthSeconds(widthSeconds),
+      ring(static_cast<std::size_t>(bucketCount), Slot{ -1, 0, 0 }),
+      lastIndex(-1),
+      occupied(0)
+{
+}
+
+UsageSeries::Slot& UsageSeries::advanceTo(long long now)
+{
+    const long long size = static_cast<long long>(ring.size());
+    long long index = now / widthSeconds;
+
+    if (index > lastIndex)
+    {
+        // Buckets skipped while nothing happened start (and stay) at the
+        // occupancy carried over; only the last `size` of them survive.
+        long long first = lastIndex < 0 ? index : std::max(lastIndex + 1, index - size + 1);
+        for (long long i = first; i <= index; ++i)
+        {
+            ring[static_cast<std::size_t>(i % size)] = Slot{ i, occupied, 0 };
+        }
+        lastIndex = index;
+    }
+
+    // A clock that stepped back keeps writing to the newest bucket.
+    return ring[static_cast<std::size_t>(lastIndex % size)];
+}
+
+void UsageSeries::onOccupancy(long long now, int occupied)
+{
+    Slot& slot = advanceTo(now);
+    this->occupied = occupied;
+    slot.peakOccupied = std::max(slot.peakOccupied, occupied);
+}
+
+void UsageSeries::onRequest(long long now)
+{
+    advanceTo(now).requests += 1;
+}
+
+void UsageSeries::read(long long now, int count, std::vector<Bucket>& out) const
+{
+    out.clear();
+    if (lastIndex < 0)
+    {
+        return;
+    }
+
+    const long long size = static_cast<long long>(ring.size());
+    long long newest = std::max(now / widthSeconds, lastIndex);
+    long long oldest = newest - std::min<long long>(std::max(count, 1), size) + 1;
+
+    for (long long i = oldest; i <= newest; ++i)
+    {
+        if (i > lastIndex)
+        {
+            out.push_back(Bucket{ i * widthSeconds, occupied, 0 });
+            continue;
+        }
+
+        const Slot& slot = ring[static_cast<std::size_t>(((i % size) + size) % size)];
+        if (slot.index == i)
+        {
+            out.push_back(Bucket{ i * widthSeconds, slot.peakOccupied, slot.requests });
+        }
+        // Otherwise the bucket predates the series (or was overwritten).
+    }
+}
+
+int UsageSeries::getWidthSeconds() const
+{
+    return widthSeconds;
+}
+
+int UsageSeries::getBucketCount() const
+{
+    return static_cast<int>(ring.size());
+}
+
+UsageHistory::ZoneUsage::ZoneUsage()
+    : minutes(60, MINUTE_BUCKETS),
+      hours(3600, HOUR_BUCKETS)
+{
+}
+
+void UsageHistory::onOccupancy(int zoneId, long long now, int occupied)
+{
+    ZoneUsage& usage = zones[zoneId];
+    usage.minutes.onOccupancy(now, occupied);
+    usage.hours.onOccupancy(now, occupied);
+}
+
+void UsageHistory::onRequest(int zoneId, long long now)
+{
+    // Only zones that have an occupancy series, so requests naming
+    // nonexistent zones cannot grow the map.
+    auto found = zones.find(zoneId);
+    if (found == zones.end())
+    {
+        return;
+    }
+
+    found->second.minutes.onRequest(now);
+    found->second.hours.onRequest(now);
+}
+
+bool UsageHistory::read(int zoneId, Resolution resolution, long long now, int count,
+                        std::vector<UsageSeries::Bucket>& out) const
+{
+    auto found = zones.find(zoneId);
+    if (found == zones.end())
+    {
+        out.clear();
+        return false;
+    }
+
+    const ZoneUsage& usage = found->second;
+    (resolution == Resolution::MINUTE ? usage.minutes : usage.hours).read(now, count, out);
+    return true;
+}
+
+int UsageHistory::bucketCount(Resolution resolution)
+{
+    return resolution == Resolution::MINUTE ? MINUTE_BUCKETS : HOUR_BUCKETS;
+}
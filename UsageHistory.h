@@ -0,0 +1,94 @@
+#ifndef USAGE_HISTORY_H
+#define USAGE_HISTORY_H
+
+#include <unordered_map>
+#include <vector>
+
+// Occupancy and request rate of one zone over fixed-width time buckets,
+// in a ring of BUCKETS entries (older buckets are overwritten).
+//
+// Updates are O(1) amortized: a bucket is initialized once, when time
+// first reaches it, carrying the current occupancy forward so quiet
+// periods still read as "this many slots were taken".
+class UsageSeries
+{
+public:
+    struct Bucket
+    {
+        long long start;     // seconds since epoch
+        int peakOccupied;    // highest occupancy seen in the bucket
+        int requests;        // requests created in the bucket
+    };
+
+private:
+    struct Slot
+    {
+        long long index;  // start / width; identifies which bucket this is
+        int peakOccupied;
+        int requests;
+    };
+
+    int widthSeconds;
+    std::vector<Slot> ring;
+    long long lastIndex;  // newest bucket initialized, -1 before the first
+    int occupied;         // current occupancy
+
+    Slot& advanceTo(long long now);
+
+public:
+    UsageSeries(int widthSeconds, int bucketCount);
+
+    void onOccupancy(long long now, int occupied);
+    void onRequest(long long now);
+
+    // The last `count` buckets up to and including now's, oldest first.
+    // Buckets the series has not reached yet are reported with the current
+    // occupancy and no requests.
+    void read(long long now, int count, std::vector<Bucket>& out) const;
+
+    int getWidthSeconds() const;
+    int getBucketCount() const;
+};
+
+// Per-zone UsageSeries at minute and hour resolution, fed by ParkingSystem
+// on every slot occupancy change and every new request.
+//
+// Not synchronized; ParkingSystem guards it with stateLock.
+class UsageHistory
+{
+public:
+    static const int MINUTE_BUCKETS = 24 * 60;     // one day
+    static const int HOUR_BUCKETS = 30 * 24;       // thirty days
+
+    enum class Resolution
+    {
+        MINUTE,
+        HOUR
+    };
+
+private:
+    struct ZoneUsage
+    {
+        UsageSeries minutes;
+        UsageSeries hours;
+
+        ZoneUsage();
+    };
+
+    std::unordered_map<int, ZoneUsage> zones;
+
+public:
+    // The first call for a zone starts its series.
+    void onOccupancy(int zoneId, long long now, int occupied);
+
+    // Ignored for zones without a series.
+    void onRequest(int zoneId, long long now);
+
+    // False if nothing was ever recorded for zoneId.
+    bool read(int zoneId, Resolution resolution, long long now, int count,
+              std::vector<UsageSeries::Bucket>& out) const;
+
+    static int bucketCount(Resolution resolution);
+};
+
+#endif  // USAGE_HISTORY_H
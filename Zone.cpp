@@ -1,7 +1,9 @@
 #include "Zone.h"
 
+#include <utility>
+
 Zone::Zone(int zoneId)
-    : zoneId(zoneId), adjacentCount(0)
+    : zoneId(zoneId), adjacentCount(0), nextSlotId(1)
 {
     for (int i = 0; i < MAX_ADJACENT_ZONES; ++i)
     {
@@ -14,21 +16,143 @@ int Zone::getZoneId() const
     return zoneId;
 }
 
+void Zone::noteSlotIds(const ParkingArea& area)
+{
+    for (int i = 0; i < area.getSlotCount(); ++i)
+    {
+        if (area.getSlotId(i) >= nextSlotId)
+        {
+            nextSlotId = area.getSlotId(i) + 1;
+        }
+    }
+}
+
 void Zone::addParkingArea(const ParkingArea& area)
 {
+    noteSlotIds(area);
     parkingAreas.push_back(area);
 }
 
-ParkingSlot* Zone::findAvailableSlotInZone()
+void Zone::addParkingArea(ParkingArea&& area)
+{
+    noteSlotIds(area);
+    parkingAreas.push_back(std::move(area));
+}
+
+ParkingArea& Zone::addArea(int areaId, int slotCount, int type)
+{
+    parkingAreas.emplace_back(areaId, zoneId, nextSlotId, slotCount, type);
+    if (slotCount > 0)
+    {
+        nextSlotId += slotCount;
+    }
+    return parkingAreas.back();
+}
+
+void Zone::reserveAreas(std::size_t count)
+{
+    parkingAreas.reserve(count);
+}
+
+void Zone::refreshIndexes()
+{
+    for (auto& area : parkingAreas)
+    {
+        area.refreshIndexes();
+    }
+}
+
+std::size_t Zone::getSlotCount() const
+{
+    std::size_t count = 0;
+    for (const auto& area : parkingAreas)
+    {
+        count += static_cast<std::size_t>(area.getSlotCount());
+    }
+    return count;
+}
+
+SlotRef Zone::findAvailableSlotInZone()
+{
+    return findFreeRunInZone(1);
+}
+
+SlotRef Zone::findFreeRunInZone(int count)
+{
+    for (auto& area : parkingAreas)
+    {
+        SlotRef slot = area.findFreeRun(count);
+        if (slot)
+        {
+            return slot;
+        }
+    }
+
+    return SlotRef();
+}
+
+SlotRef Zone::findFreeRunInZone(int count, int type)
+{
+    for (auto& area : parkingAreas)
+    {
+        SlotRef slot = area.findFreeRun(count, type);
+        if (slot)
+        {
+            return slot;
+        }
+    }
+
+    return SlotRef();
+}
+
+SlotRef Zone::findFreeSlotOfType(int type, int powerWatts)
 {
     for (auto& area : parkingAreas)
     {
-        ParkingSlot* slot = area.getFirstAvailableSlot();
-        if (slot != nullptr)
+        if (powerWatts > 0 && area.getPowerHeadroom() < powerWatts)
+        {
+            continue;
+        }
+
+        SlotRef slot = area.findFreeOfType(type);
+        if (slot)
         {
             return slot;
         }
     }
 
-    return nullptr;
-}
\ No newline at end of file
+    return SlotRef();
+}
+
+int Zone::peekFreeSlotOfType(int type) const
+{
+    for (const auto& area : parkingAreas)
+    {
+        int index = area.peekFreeOfType(type);
+        if (index >= 0)
+        {
+            return area.getSlotId(index);
+        }
+    }
+
+    return -1;
+}
+
+const std::vector<ParkingArea>& Zone::getParkingAreas() const
+{
+    return parkingAreas;
+}
+
+SlotRef Zone::findSlot(int slotId)
+{
+    for (auto& area : parkingAreas)
+    {
+        SlotRef slot = area.findSlot(slotId);
+        if (slot)
+        {
+            return slot;
+        }
+    }
+
+    return SlotRef();
+}
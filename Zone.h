@@ -1,6 +1,7 @@
 #ifndef ZONE_H
 #define ZONE_H
 
+#include <cstddef>
 #include <vector>
 
 #include "ParkingArea.h"
@@ -15,15 +16,56 @@ private:
     int adjacentZones[MAX_ADJACENT_ZONES];
     int adjacentCount;
 
+    // One past the highest slot id in the zone; addArea() numbers from here
+    // so (zoneId, slotId) stays unique.
+    int nextSlotId;
+
+    void noteSlotIds(const ParkingArea& area);
+
 public:
     Zone(int zoneId);
 
     int getZoneId() const;
 
     void addParkingArea(const ParkingArea& area);
+    void addParkingArea(ParkingArea&& area);
+
+    // Builds an area of slotCount free slots of one type directly inside
+    // the zone, with slot ids continuing the zone's numbering. Returns the
+    // new area.
+    ParkingArea& addArea(int areaId, int slotCount, int type = 0);
+
+    // Call before a run of addArea() calls to size the area list once.
+    void reserveAreas(std::size_t count);
+
+    // Builds every area's free-slot indexes now rather than on first use.
+    void refreshIndexes();
+
+    // Total number of slots across all areas.
+    std::size_t getSlotCount() const;
+
+    // Returns the first available slot within this zone, or an empty handle if none
+    SlotRef findAvailableSlotInZone();
+
+    // First slot of count adjacent free slots within one area (runs never
+    // span areas), earliest area first; an empty handle if none.
+    SlotRef findFreeRunInZone(int count);
+
+    // The same, but every slot of the run has this type.
+    SlotRef findFreeRunInZone(int count, int type);
+
+    // Some free slot of this type, O(areas); an empty handle if none. With
+    // powerWatts > 0 only areas with that much charging headroom qualify.
+    SlotRef findFreeSlotOfType(int type, int powerWatts = 0);
+
+    // Id of a free slot of this type, or -1, without touching the zone
+    // (see ParkingArea::peekFreeOfType). O(areas x log slots).
+    int peekFreeSlotOfType(int type) const;
+
+    const std::vector<ParkingArea>& getParkingAreas() const;
 
-    // Returns pointer to first available slot within this zone, or nullptr if none
-    ParkingSlot* findAvailableSlotInZone();
+    // Returns the slot with this id in any of the zone's areas, or an empty handle.
+    SlotRef findSlot(int slotId);
 };
 
 #endif  // ZONE_H
@@ -0,0 +1,254 @@
+// Round-trip latency of the gate binary protocol (GateServer) against the
+// HTTP API for the same work: a vehicle's request -> occupy -> release.
+//
+//   http       one keep-alive HTTP connection, one call at a time
+//   gate       one gate connection, one frame at a time
+//   gate-pipe  one gate connection, --pipeline lifecycles in flight; the
+//              latency reported is the round trip of a whole window
+//
+// usage: gate_latency [--port 8080] [--gate-port 9090] [--vehicles 2000]
+//                     [--pipeline 32]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef ASIO_STANDALONE
+#define ASIO_STANDALONE
+#endif
+#include <asio.hpp>
+
+#include "../GateProtocol.h"
+#include "http_client.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+    const int ZONE_ID = 100;
+    const int SLOTS = 200;
+
+    struct Options
+    {
+        unsigned short port = 8080;
+        unsigned short gatePort = 9090;
+        int vehicles = 2000;
+        int pipeline = 32;
+    };
+
+    struct Result
+    {
+        std::vector<std::uint32_t> latencyMicros;
+        std::uint64_t operations = 0;
+        std::uint64_t errors = 0;
+        double seconds = 0;
+    };
+
+    class GateClient
+    {
+    private:
+        asio::io_context io;
+        asio::ip::tcp::socket socket;
+        std::string out;
+        std::vector<unsigned char> in;
+
+    public:
+        explicit GateClient(unsigned short port)
+            : socket(io)
+        {
+            socket.connect(asio::ip::tcp::endpoint(asio::ip::make_address("127.0.0.1"), port));
+            socket.set_option(asio::ip::tcp::no_delay(true));
+        }
+
+        void add(GateProtocol::Op op, std::uint32_t tag, int arg, const std::string& vehicleId = std::string())
+        {
+            GateProtocol::appendRequest(out, op, tag, arg, vehicleId);
+        }
+
+        // Sends everything added so far in one write and reads one reply per
+        // frame, indexed by tag.
+        void roundTrip(std::vector<GateProtocol::Reply>& replies)
+        {
+            std::size_t frames = out.size() / GateProtocol::REQUEST_BYTES;
+            asio::write(socket, asio::buffer(out));
+            out.clear();
+
+            in.resize(frames * GateProtocol::REPLY_BYTES);
+            asio::read(socket, asio::buffer(in));
+
+            replies.assign(frames, GateProtocol::Reply());
+            for (std::size_t i = 0; i < frames; ++i)
+            {
+                GateProtocol::Reply reply = GateProtocol::decodeReply(in.data() + i * GateProtocol::REPLY_BYTES);
+                if (reply.tag < frames)
+                {
+                    replies[reply.tag] = reply;
+                }
+            }
+        }
+    };
+
+    std::uint32_t elapsedMicros(Clock::time_point start)
+    {
+        return static_cast<std::uint32_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+    }
+
+    Result runHttp(const Options& options)
+    {
+        HttpClient client(options.port);
+        Result result;
+        std::string body;
+
+        Clock::time_point begin = Clock::now();
+        for (int v = 0; v < options.vehicles; ++v)
+        {
+            std::string payload = "{\"vehicleId\":\"H" + std::to_string(v) +
+                                  "\",\"requestedZoneId\":" + std::to_string(ZONE_ID) + "}";
+
+            Clock::time_point start = Clock::now();
+            int status = client.call("POST", "/api/parking/requests", payload, body);
+            result.latencyMicros.push_back(elapsedMicros(start));
+            ++result.operations;
+
+            std::size_t at = body.find("\"id\":");
+            if (status != 201 || at == std::string::npos)
+            {
+                ++result.errors;
+                continue;
+            }
+
+            std::string prefix = "/api/parking/requests/" + std::to_string(std::atoi(body.c_str() + at + 5));
+            for (const char* action : { "/occupy", "/release" })
+            {
+                start = Clock::now();
+                if (client.call("PUT", prefix + action, std::string(), body) != 200)
+                {
+                    ++result.errors;
+                }
+                result.latencyMicros.push_back(elapsedMicros(start));
+                ++result.operations;
+            }
+        }
+        result.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+        return result;
+    }
+
+    // window == 1 is the one-frame-at-a-time case.
+    Result runGate(const Options& options, int window)
+    {
+        GateClient client(options.gatePort);
+        Result result;
+        std::vector<GateProtocol::Reply> replies;
+        std::vector<int> requestIds;
+
+        Clock::time_point begin = Clock::now();
+        for (int first = 0; first < options.vehicles; first += window)
+        {
+            int count = std::min(window, options.vehicles - first);
+
+            Clock::time_point start = Clock::now();
+            for (int i = 0; i < count; ++i)
+            {
+                client.add(GateProtocol::REQUEST, static_cast<std::uint32_t>(i), ZONE_ID, "G" + std::to_string(first + i));
+            }
+            client.roundTrip(replies);
+            result.latencyMicros.push_back(elapsedMicros(start));
+
+            requestIds.clear();
+            for (const auto& reply : replies)
+            {
+                if (reply.status == GateProtocol::OK)
+                {
+                    requestIds.push_back(reply.requestId);
+                }
+                else
+                {
+                    ++result.errors;
+                }
+            }
+            result.operations += static_cast<std::uint64_t>(count);
+
+            for (GateProtocol::Op op : { GateProtocol::OCCUPY, GateProtocol::RELEASE })
+            {
+                start = Clock::now();
+                for (std::size_t i = 0; i < requestIds.size(); ++i)
+                {
+                    client.add(op, static_cast<std::uint32_t>(i), requestIds[i]);
+                }
+                client.roundTrip(replies);
+                result.latencyMicros.push_back(elapsedMicros(start));
+
+                for (const auto& reply : replies)
+                {
+                    if (reply.status != GateProtocol::OK)
+                    {
+                        ++result.errors;
+                    }
+                }
+                result.operations += requestIds.size();
+            }
+        }
+        result.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+        return result;
+    }
+
+    std::uint32_t percentile(const std::vector<std::uint32_t>& sorted, double p)
+    {
+        if (sorted.empty())
+        {
+            return 0;
+        }
+        std::size_t at = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1));
+        return sorted[at];
+    }
+
+    void report(const char* name, Result result)
+    {
+        std::sort(result.latencyMicros.begin(), result.latencyMicros.end());
+        std::cout << name
+                  << "  ops/s " << static_cast<std::uint64_t>(result.operations / result.seconds)
+                  << "  rtt p50 " << percentile(result.latencyMicros, 0.50) << "us"
+                  << "  p99 " << percentile(result.latencyMicros, 0.99) << "us"
+                  << "  errors " << result.errors << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        int value = std::atoi(argv[i + 1]);
+        if (std::strcmp(argv[i], "--port") == 0) options.port = static_cast<unsigned short>(value);
+        else if (std::strcmp(argv[i], "--gate-port") == 0) options.gatePort = static_cast<unsigned short>(value);
+        else if (std::strcmp(argv[i], "--vehicles") == 0) options.vehicles = value;
+        else if (std::strcmp(argv[i], "--pipeline") == 0) options.pipeline = std::max(1, std::min(value, SLOTS));
+    }
+
+    try
+    {
+        HttpClient setup(options.port);
+        std::string body;
+        setup.call("POST", "/api/zones",
+                   "{\"id\":" + std::to_string(ZONE_ID) + ",\"areas\":[{\"areaId\":1,\"slots\":" +
+                   std::to_string(SLOTS) + "}]}",
+                   body);
+
+        report("http      ", runHttp(options));
+        report("gate      ", runGate(options, 1));
+        report("gate-pipe ", runGate(options, options.pipeline));
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "gate_latency: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#ifndef BENCH_HTTP_CLIENT_H
+#define BENCH_HTTP_CLIENT_H
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#ifndef ASIO_STANDALONE
+#define ASIO_STANDALONE
+#endif
+#include <asio.hpp>
+
+// Blocking keep-alive HTTP/1.1 client shared by the bench tools. Just
+// enough of the protocol for the server's JSON endpoints (Content-Length
+// bodies only).
+class HttpClient
+{
+private:
+    asio::io_context io;
+    asio::ip::tcp::socket socket;
+    asio::streambuf buffer;
+    std::string request;
+
+public:
+    explicit HttpClient(unsigned short port)
+        : socket(io)
+    {
+        socket.connect(asio::ip::tcp::endpoint(asio::ip::make_address("127.0.0.1"), port));
+        socket.set_option(asio::ip::tcp::no_delay(true));
+    }
+
+    // Sends one request and reads the whole response. Returns the status
+    // code (0 on a protocol error); the body is stored in `body`.
+    int call(const char* method, const std::string& target, const std::string& payload, std::string& body)
+    {
+        request.clear();
+        request += method;
+        request += ' ';
+        request += target;
+        request += " HTTP/1.1\r\nHost: localhost\r\nConnection: keep-alive\r\n";
+        if (!payload.empty())
+        {
+            request += "Content-Type: application/json\r\nContent-Length: ";
+            request += std::to_string(payload.size());
+            request += "\r\n";
+        }
+        request += "\r\n";
+        request += payload;
+
+        asio::write(socket, asio::buffer(request));
+
+        std::size_t headEnd = asio::read_until(socket, buffer, "\r\n\r\n");
+        std::string head(asio::buffers_begin(buffer.data()),
+                         asio::buffers_begin(buffer.data()) + headEnd);
+        buffer.consume(headEnd);
+
+        int status = 0;
+        if (head.size() > 12)
+        {
+            status = std::atoi(head.c_str() + 9);
+        }
+
+        std::size_t length = 0;
+        for (const char* name : { "Content-Length:", "content-length:" })
+        {
+            std::size_t at = head.find(name);
+            if (at != std::string::npos)
+            {
+                length = std::strtoul(head.c_str() + at + std::strlen(name), nullptr, 10);
+                break;
+            }
+        }
+
+        if (buffer.size() < length)
+        {
+            asio::read(socket, buffer, asio::transfer_exactly(length - buffer.size()));
+        }
+        body.assign(asio::buffers_begin(buffer.data()),
+                    asio::buffers_begin(buffer.data()) + length);
+        buffer.consume(length);
+        return status;
+    }
+};
+
+#endif  // BENCH_HTTP_CLIENT_H
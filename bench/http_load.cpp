@@ -0,0 +1,209 @@
+// Closed-loop HTTP load generator for bench/run_concurrency_bench.sh.
+//
+// Each connection is a keep-alive socket on its own thread that sends the
+// next request as soon as the previous response arrives. The mix is:
+//   reads  - GET /api/zones/<id>                 (cached snapshot render)
+//            GET /api/zones/<id>?state=OCCUPIED  (index query, shared lock)
+//            GET /api/parking/requests?zone=<id>&limit=20
+//   writes - POST /api/parking/requests followed by PUT .../cancel
+//            (exclusive lock)
+//
+// usage: http_load [--port 8080] [--connections 32] [--seconds 5]
+//                  [--write-percent 10] [--zones 8]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef ASIO_STANDALONE
+#define ASIO_STANDALONE
+#endif
+#include <asio.hpp>
+
+#include "http_client.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+    const int FIRST_ZONE_ID = 100;
+    const int SLOTS_PER_ZONE = 200;
+
+    struct Options
+    {
+        unsigned short port = 8080;
+        int connections = 32;
+        int seconds = 5;
+        int writePercent = 10;
+        int zones = 8;
+    };
+
+    struct Stats
+    {
+        std::uint64_t reads = 0;
+        std::uint64_t writes = 0;
+        std::uint64_t errors = 0;
+        std::vector<std::uint32_t> latencyMicros;
+    };
+
+    // xorshift32: cheap per-thread randomness for the request mix.
+    std::uint32_t nextRandom(std::uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    void createZones(const Options& options)
+    {
+        HttpClient client(options.port);
+        std::string body;
+        for (int z = 0; z < options.zones; ++z)
+        {
+            std::string payload = "{\"id\":" + std::to_string(FIRST_ZONE_ID + z) +
+                                  ",\"areas\":[{\"areaId\":1,\"slots\":" +
+                                  std::to_string(SLOTS_PER_ZONE) + "}]}";
+            client.call("POST", "/api/zones", payload, body);
+        }
+    }
+
+    void runConnection(const Options& options, int index, Clock::time_point deadline, Stats& stats)
+    {
+        HttpClient client(options.port);
+        std::uint32_t random = 2463534242u + static_cast<std::uint32_t>(index) * 7919u;
+        std::string body;
+        std::string target;
+        int vehicle = 0;
+
+        while (Clock::now() < deadline)
+        {
+            int zoneId = FIRST_ZONE_ID + static_cast<int>(nextRandom(random) % options.zones);
+            bool write = static_cast<int>(nextRandom(random) % 100) < options.writePercent;
+
+            Clock::time_point start = Clock::now();
+            bool ok = true;
+
+            if (write)
+            {
+                std::string payload = "{\"vehicleId\":\"B" + std::to_string(index) + "-" +
+                                      std::to_string(vehicle++) + "\",\"requestedZoneId\":" +
+                                      std::to_string(zoneId) + "}";
+                int status = client.call("POST", "/api/parking/requests", payload, body);
+                ok = status == 201 || status == 409;
+
+                std::size_t at = body.find("\"id\":");
+                if (status == 201 && at != std::string::npos)
+                {
+                    int requestId = std::atoi(body.c_str() + at + 5);
+                    target = "/api/parking/requests/" + std::to_string(requestId) + "/cancel";
+                    ok = client.call("PUT", target, std::string(), body) == 200;
+                }
+                ++stats.writes;
+            }
+            else
+            {
+                switch (nextRandom(random) % 3)
+                {
+                case 0: target = "/api/zones/" + std::to_string(zoneId); break;
+                case 1: target = "/api/zones/" + std::to_string(zoneId) + "?state=OCCUPIED"; break;
+                default: target = "/api/parking/requests?zone=" + std::to_string(zoneId) + "&limit=20"; break;
+                }
+                ok = client.call("GET", target, std::string(), body) == 200;
+                ++stats.reads;
+            }
+
+            if (!ok)
+            {
+                ++stats.errors;
+            }
+
+            auto micros = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+            stats.latencyMicros.push_back(static_cast<std::uint32_t>(micros.count()));
+        }
+    }
+
+    std::uint32_t percentile(const std::vector<std::uint32_t>& sorted, double p)
+    {
+        if (sorted.empty())
+        {
+            return 0;
+        }
+        std::size_t at = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1));
+        return sorted[at];
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        int value = std::atoi(argv[i + 1]);
+        if (std::strcmp(argv[i], "--port") == 0) options.port = static_cast<unsigned short>(value);
+        else if (std::strcmp(argv[i], "--connections") == 0) options.connections = value;
+        else if (std::strcmp(argv[i], "--seconds") == 0) options.seconds = value;
+        else if (std::strcmp(argv[i], "--write-percent") == 0) options.writePercent = value;
+        else if (std::strcmp(argv[i], "--zones") == 0) options.zones = value;
+    }
+
+    try
+    {
+        createZones(options);
+
+        std::vector<Stats> stats(static_cast<std::size_t>(options.connections));
+        std::vector<std::thread> threads;
+        Clock::time_point deadline = Clock::now() + std::chrono::seconds(options.seconds);
+
+        for (int i = 0; i < options.connections; ++i)
+        {
+            threads.emplace_back([&, i]()
+            {
+                try
+                {
+                    runConnection(options, i, deadline, stats[static_cast<std::size_t>(i)]);
+                }
+                catch (const std::exception& e)
+                {
+                    std::cerr << "connection " << i << ": " << e.what() << std::endl;
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        Stats total;
+        for (const auto& s : stats)
+        {
+            total.reads += s.reads;
+            total.writes += s.writes;
+            total.errors += s.errors;
+            total.latencyMicros.insert(total.latencyMicros.end(), s.latencyMicros.begin(), s.latencyMicros.end());
+        }
+        std::sort(total.latencyMicros.begin(), total.latencyMicros.end());
+
+        double seconds = static_cast<double>(options.seconds);
+        std::cout << "ops/s " << static_cast<std::uint64_t>((total.reads + total.writes) / seconds)
+                  << "  reads/s " << static_cast<std::uint64_t>(total.reads / seconds)
+                  << "  writes/s " << static_cast<std::uint64_t>(total.writes / seconds)
+                  << "  p50 " << percentile(total.latencyMicros, 0.50) << "us"
+                  << "  p99 " << percentile(total.latencyMicros, 0.99) << "us"
+                  << "  errors " << total.errors << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "http_load: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
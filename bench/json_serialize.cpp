@@ -0,0 +1,148 @@
+// Serialization cost of a large GET /api/parking/requests-style body: the
+// original std::ostringstream + jsonEscape code path against JsonWriter.
+// Both render the same synthetic requests (some vehicle ids need escaping)
+// and the output is checked to be byte-identical. Reports the best of
+// several warm runs of each.
+//
+// usage: json_serialize [--requests 100000] [--runs 5]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../JsonWriter.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+    struct Record
+    {
+        int id;
+        std::string vehicleId;
+        int zoneId;
+        int slotId;
+        const char* status;
+    };
+
+    // Copied from the handler JsonWriter replaced.
+    std::string jsonEscape(const std::string& s)
+    {
+        std::ostringstream out;
+        for (char c : s)
+        {
+            switch (c)
+            {
+            case '\\': out << "\\\\"; break;
+            case '\"': out << "\\\""; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    out << "\\u"
+                        << std::hex << std::uppercase << std::setfill('0') << std::setw(4)
+                        << (int)(unsigned char)c;
+                }
+                else
+                {
+                    out << c;
+                }
+            }
+        }
+        return out.str();
+    }
+
+    std::string withStream(const std::vector<Record>& records)
+    {
+        std::ostringstream out;
+        out << "{\"requests\":[";
+        bool first = true;
+        for (const auto& r : records)
+        {
+            if (!first) out << ",";
+            first = false;
+            out << "{"
+                << "\"id\":" << r.id << ","
+                << "\"vehicleId\":\"" << jsonEscape(r.vehicleId) << "\","
+                << "\"zoneId\":" << r.zoneId << ","
+                << "\"slotNumber\":" << r.slotId << ","
+                << "\"status\":\"" << r.status << "\","
+                << "\"timestamp\":\"Recently\""
+                << "}";
+        }
+        out << "]}";
+        return out.str();
+    }
+
+    std::string withWriter(const std::vector<Record>& records)
+    {
+        JsonWriter json;
+        json.beginObject().key("requests").beginArray();
+        for (const auto& r : records)
+        {
+            json.beginObject()
+                .field("id", r.id)
+                .field("vehicleId", r.vehicleId)
+                .field("zoneId", r.zoneId)
+                .field("slotNumber", r.slotId)
+                .field("status", r.status)
+                .field("timestamp", "Recently")
+                .endObject();
+        }
+        json.endArray().endObject();
+        return json.str();
+    }
+
+    template <typename Render>
+    double bestMillis(int runs, Render render, std::string& output)
+    {
+        double best = 1e30;
+        for (int i = 0; i < runs; ++i)
+        {
+            auto start = Clock::now();
+            output = render();
+            best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+        return best;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int requestCount = 100000;
+    int runs = 5;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (std::strcmp(argv[i], "--requests") == 0) requestCount = std::atoi(argv[i + 1]);
+        if (std::strcmp(argv[i], "--runs") == 0) runs = std::atoi(argv[i + 1]);
+    }
+
+    static const char* STATES[] = { "REQUESTED", "ALLOCATED", "OCCUPIED", "RELEASED", "CANCELLED" };
+    std::vector<Record> records;
+    records.reserve(static_cast<std::size_t>(requestCount));
+    for (int i = 0; i < requestCount; ++i)
+    {
+        std::string vehicle = "VEH-" + std::to_string(100000 + i);
+        if (i % 50 == 0) vehicle += "\t\"quoted\"";
+        records.push_back(Record{ i, vehicle, 1 + i % 20, 1 + i % 500, STATES[i % 5] });
+    }
+
+    std::string before;
+    std::string after;
+    double streamMs = bestMillis(runs, [&] { return withStream(records); }, before);
+    double writerMs = bestMillis(runs, [&] { return withWriter(records); }, after);
+
+    std::cout << requestCount << " requests, " << after.size() / 1024 << " KiB body\n"
+              << "  ostringstream  " << std::fixed << std::setprecision(1) << streamMs << " ms\n"
+              << "  JsonWriter     " << writerMs << " ms\n"
+              << "  identical      " << (before == after ? "yes" : "NO") << "\n";
+    return before == after ? 0 : 1;
+}
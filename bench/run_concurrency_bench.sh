@@ -0,0 +1,25 @@
+#!/bin/bash
+# Mixed read/write throughput of the server at 1, 2, 4, 8 and 16 Crow
+# worker threads. Run from the repository root after ./build_server.sh.
+#
+#   bench/run_concurrency_bench.sh [seconds] [write-percent]
+
+SECONDS_PER_RUN=${1:-5}
+WRITE_PERCENT=${2:-10}
+
+g++ -std=c++17 -O2 bench/http_load.cpp \
+    -Iserver/asio-master/include \
+    -o bench/http_load \
+    -pthread || exit 1
+
+for THREADS in 1 2 4 8 16; do
+    ./smart_parking_server --threads $THREADS > /dev/null 2>&1 &
+    SERVER_PID=$!
+    sleep 1
+
+    printf "threads %2d  " $THREADS
+    bench/http_load --connections 32 --seconds $SECONDS_PER_RUN --write-percent $WRITE_PERCENT
+
+    kill $SERVER_PID
+    wait $SERVER_PID 2>/dev/null
+done
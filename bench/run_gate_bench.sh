@@ -0,0 +1,22 @@
+#!/bin/bash
+# Request -> occupy -> release round trips over HTTP and over the gate
+# binary protocol. Run from the repository root after ./build_server.sh.
+#
+#   bench/run_gate_bench.sh [vehicles] [pipeline]
+
+VEHICLES=${1:-2000}
+PIPELINE=${2:-32}
+
+g++ -std=c++17 -O2 bench/gate_latency.cpp \
+    -Iserver/asio-master/include \
+    -o bench/gate_latency \
+    -pthread || exit 1
+
+./smart_parking_server > /dev/null 2>&1 &
+SERVER_PID=$!
+sleep 1
+
+bench/gate_latency --vehicles $VEHICLES --pipeline $PIPELINE
+
+kill $SERVER_PID
+wait $SERVER_PID 2>/dev/null
@@ -0,0 +1,13 @@
+#!/bin/bash
+# JsonWriter against the ostringstream serialization it replaced. Run from
+# the repository root.
+#
+#   bench/run_json_bench.sh [requests] [runs]
+
+REQUESTS=${1:-100000}
+RUNS=${2:-5}
+
+g++ -std=c++17 -O2 bench/json_serialize.cpp JsonWriter.cpp \
+    -o bench/json_serialize || exit 1
+
+bench/json_serialize --requests $REQUESTS --runs $RUNS
@@ -0,0 +1,14 @@
+#!/bin/bash
+# ReadWriteLock against std::shared_mutex: read scaling at 1-16 threads and
+# reader / writer progress under a continuous writer stream. Run from the
+# repository root; scaling needs a machine with that many cores.
+#
+#   bench/run_rwlock_bench.sh [seconds]
+
+SECONDS_PER_RUN=${1:-2}
+
+g++ -std=c++17 -O2 bench/rwlock_bench.cpp ReadWriteLock.cpp \
+    -o bench/rwlock_bench \
+    -pthread || exit 1
+
+bench/rwlock_bench --seconds $SECONDS_PER_RUN
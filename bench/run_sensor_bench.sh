@@ -0,0 +1,22 @@
+#!/bin/bash
+# Sensor event ingestion at a fixed UDP rate. Run from the repository root
+# after ./build_server.sh.
+#
+#   bench/run_sensor_bench.sh [events-per-second] [seconds]
+
+RATE=${1:-100000}
+SECONDS_TO_RUN=${2:-5}
+
+g++ -std=c++17 -O2 bench/sensor_load.cpp \
+    -Iserver/asio-master/include \
+    -o bench/sensor_load \
+    -pthread || exit 1
+
+./smart_parking_server > /dev/null 2>&1 &
+SERVER_PID=$!
+sleep 1
+
+bench/sensor_load --rate $RATE --seconds $SECONDS_TO_RUN
+
+kill $SERVER_PID
+wait $SERVER_PID 2>/dev/null
@@ -0,0 +1,19 @@
+#!/bin/bash
+# Bytes per slot of the zone model, its free-slot indexes and its snapshot,
+# plus the cost of one snapshot update on a large zone. Run from the
+# repository root; needs glibc (mallinfo2).
+#
+#   bench/run_slot_memory_bench.sh [slots] [area size]
+
+SLOTS=${1:-1000000}
+AREA=${2:-1000}
+
+g++ -std=c++20 -O2 bench/slot_memory.cpp \
+    ParkingSystem.cpp ParkingSnapshot.cpp AllocateEngine.cpp Zone.cpp ParkingArea.cpp \
+    FreeRunTree.cpp ParkingSlot.cpp ParkingRequest.cpp Vehicle.cpp FacilityTree.cpp \
+    PriceCurve.cpp RequestIndex.cpp RequestStats.cpp TDigest.cpp SlotWaiters.cpp \
+    UsageHistory.cpp ReadWriteLock.cpp \
+    -o bench/slot_memory \
+    -pthread || exit 1
+
+bench/slot_memory --slots $SLOTS --area $AREA
@@ -0,0 +1,139 @@
+// ReadWriteLock against std::shared_mutex, outside the server.
+//
+//  1. Read scaling: N threads take the lock shared around a short read,
+//     no writers. Reports total shared acquisitions per second.
+//  2. Writer stream: 2 threads take the lock exclusively back to back
+//     while N readers keep reading. Reports reader and writer progress
+//     and the longest single wait for a shared acquisition, i.e. whether
+//     one side starves the other.
+//
+// Scaling numbers only mean something with at least as many cores as
+// threads; the starvation numbers are meaningful on any machine.
+//
+// usage: rwlock_bench [--seconds 2]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../ReadWriteLock.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+    struct Result
+    {
+        long long reads;
+        long long writes;
+        double maxReadWaitMs;
+    };
+
+    // Some shared state to read and write under the lock.
+    struct Shared
+    {
+        long long values[16] = {};
+    };
+
+    template <typename Lock>
+    Result run(int readers, int writers, double seconds)
+    {
+        Lock lock;
+        Shared shared;
+        std::atomic<bool> stop(false);
+        std::atomic<long long> reads(0);
+        std::atomic<long long> writes(0);
+        std::atomic<long long> maxWaitNanos(0);
+
+        std::vector<std::thread> threads;
+        for (int r = 0; r < readers; ++r)
+        {
+            threads.emplace_back([&]() {
+                long long done = 0;
+                long long worst = 0;
+                long long sink = 0;
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    auto start = Clock::now();
+                    lock.lock_shared();
+                    worst = std::max<long long>(worst, (Clock::now() - start).count());
+                    for (long long v : shared.values) sink += v;
+                    lock.unlock_shared();
+                    ++done;
+                }
+                reads += done + (sink == -1 ? 1 : 0);
+                long long seen = maxWaitNanos.load();
+                while (worst > seen && !maxWaitNanos.compare_exchange_weak(seen, worst)) {}
+            });
+        }
+        for (int w = 0; w < writers; ++w)
+        {
+            threads.emplace_back([&]() {
+                long long done = 0;
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    lock.lock();
+                    for (long long& v : shared.values) ++v;
+                    lock.unlock();
+                    ++done;
+                }
+                writes += done;
+            });
+        }
+
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        stop = true;
+        for (auto& thread : threads) thread.join();
+
+        return Result{ reads.load(), writes.load(), maxWaitNanos.load() / 1e6 };
+    }
+
+    template <typename Lock>
+    void report(const char* name, int readers, int writers, double seconds)
+    {
+        Result result = run<Lock>(readers, writers, seconds);
+        std::cout << "  " << std::left << std::setw(18) << name << std::right
+                  << " readers " << std::setw(2) << readers
+                  << "  reads/s " << std::setw(11) << static_cast<long long>(result.reads / seconds);
+        if (writers > 0)
+        {
+            std::cout << "  writes/s " << std::setw(10) << static_cast<long long>(result.writes / seconds)
+                      << "  max read wait " << std::fixed << std::setprecision(2) << result.maxReadWaitMs << " ms";
+        }
+        std::cout << "\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    double seconds = 2;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (std::strcmp(argv[i], "--seconds") == 0) seconds = std::atof(argv[i + 1]);
+    }
+
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << "\n";
+
+    std::cout << "read scaling (no writers)\n";
+    for (int readers : { 1, 2, 4, 8, 16 })
+    {
+        report<ReadWriteLock>("ReadWriteLock", readers, 0, seconds);
+        report<std::shared_mutex>("std::shared_mutex", readers, 0, seconds);
+    }
+
+    std::cout << "writer stream (2 writers back to back)\n";
+    for (int readers : { 1, 4, 16 })
+    {
+        report<ReadWriteLock>("ReadWriteLock", readers, 2, seconds);
+        report<std::shared_mutex>("std::shared_mutex", readers, 2, seconds);
+    }
+    return 0;
+}
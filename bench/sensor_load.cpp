@@ -0,0 +1,186 @@
+// Open-loop UDP load for SensorListener: streams slot sensor events at a
+// fixed rate, with duplicated and reordered datagrams mixed in, and reports
+// how many datagrams the kernel dropped for lack of receive buffer while it
+// ran (Linux, from /proc/net/snmp; any UDP socket on the host counts).
+//
+// usage: sensor_load [--port 9091] [--rate 100000] [--seconds 5]
+//                    [--zone 100] [--slots 200] [--batch 64]
+//                    [--duplicate-percent 5] [--reorder-percent 5]
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef ASIO_STANDALONE
+#define ASIO_STANDALONE
+#endif
+#include <asio.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+    struct Options
+    {
+        unsigned short port = 9091;
+        int rate = 100000;
+        int seconds = 5;
+        int zone = 100;
+        int slots = 200;
+        int batch = 64;
+        int duplicatePercent = 5;
+        int reorderPercent = 5;
+    };
+
+    void writeU32(unsigned char* p, std::uint32_t v)
+    {
+        p[0] = static_cast<unsigned char>(v);
+        p[1] = static_cast<unsigned char>(v >> 8);
+        p[2] = static_cast<unsigned char>(v >> 16);
+        p[3] = static_cast<unsigned char>(v >> 24);
+    }
+
+    std::uint32_t nextRandom(std::uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    // Udp: RcvbufErrors from /proc/net/snmp, or -1 where unavailable.
+    long long receiveBufferErrors()
+    {
+        std::ifstream snmp("/proc/net/snmp");
+        std::string names;
+        std::string values;
+        while (std::getline(snmp, names) && std::getline(snmp, values))
+        {
+            if (names.compare(0, 4, "Udp:") != 0)
+            {
+                continue;
+            }
+
+            std::istringstream n(names);
+            std::istringstream v(values);
+            std::string name;
+            std::string value;
+            while (n >> name && v >> value)
+            {
+                if (name == "RcvbufErrors")
+                {
+                    return std::atoll(value.c_str());
+                }
+            }
+        }
+        return -1;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        int value = std::atoi(argv[i + 1]);
+        if (std::strcmp(argv[i], "--port") == 0) options.port = static_cast<unsigned short>(value);
+        else if (std::strcmp(argv[i], "--rate") == 0) options.rate = value;
+        else if (std::strcmp(argv[i], "--seconds") == 0) options.seconds = value;
+        else if (std::strcmp(argv[i], "--zone") == 0) options.zone = value;
+        else if (std::strcmp(argv[i], "--slots") == 0) options.slots = value;
+        else if (std::strcmp(argv[i], "--batch") == 0) options.batch = value;
+        else if (std::strcmp(argv[i], "--duplicate-percent") == 0) options.duplicatePercent = value;
+        else if (std::strcmp(argv[i], "--reorder-percent") == 0) options.reorderPercent = value;
+    }
+
+    asio::io_context io;
+    asio::ip::udp::socket socket(io, asio::ip::udp::v4());
+    asio::ip::udp::endpoint target(asio::ip::make_address("127.0.0.1"), options.port);
+
+    std::vector<std::uint32_t> sequences(static_cast<std::size_t>(options.slots), 0);
+    std::vector<unsigned char> occupied(static_cast<std::size_t>(options.slots), 0);
+    std::uint32_t random = 2463534242u;
+
+    std::vector<unsigned char> current;
+    std::vector<unsigned char> held;  // a datagram delayed behind the next one
+    std::uint64_t events = 0;
+    std::uint64_t datagrams = 0;
+
+    long long dropsBefore = receiveBufferErrors();
+    Clock::time_point begin = Clock::now();
+    Clock::time_point deadline = begin + std::chrono::seconds(options.seconds);
+    const double secondsPerEvent = 1.0 / options.rate;
+
+    while (Clock::now() < deadline)
+    {
+        current.assign(4 + static_cast<std::size_t>(options.batch) * 16, 0);
+        current[0] = 1;
+        current[2] = static_cast<unsigned char>(options.batch);
+        current[3] = static_cast<unsigned char>(options.batch >> 8);
+
+        for (int e = 0; e < options.batch; ++e)
+        {
+            std::size_t slot = nextRandom(random) % static_cast<std::uint32_t>(options.slots);
+            if (nextRandom(random) % 10 == 0)
+            {
+                occupied[slot] ^= 1;  // most events are heartbeats
+            }
+
+            unsigned char* event = current.data() + 4 + static_cast<std::size_t>(e) * 16;
+            writeU32(event, static_cast<std::uint32_t>(options.zone));
+            writeU32(event + 4, static_cast<std::uint32_t>(slot + 1));
+            writeU32(event + 8, ++sequences[slot]);
+            event[12] = occupied[slot];
+        }
+
+        if (static_cast<int>(nextRandom(random) % 100) < options.reorderPercent && held.empty())
+        {
+            held.swap(current);
+        }
+        else
+        {
+            socket.send_to(asio::buffer(current), target);
+            ++datagrams;
+            if (static_cast<int>(nextRandom(random) % 100) < options.duplicatePercent)
+            {
+                socket.send_to(asio::buffer(current), target);
+                ++datagrams;
+            }
+            if (!held.empty())
+            {
+                socket.send_to(asio::buffer(held), target);
+                ++datagrams;
+                held.clear();
+            }
+        }
+
+        events += static_cast<std::uint64_t>(options.batch);
+        std::this_thread::sleep_until(begin + std::chrono::duration_cast<Clock::duration>(
+                                                  std::chrono::duration<double>(events * secondsPerEvent)));
+    }
+
+    double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    long long dropsAfter = receiveBufferErrors();
+
+    std::cout << "events/s " << static_cast<std::uint64_t>(events / seconds)
+              << "  datagrams " << datagrams
+              << "  kernel drops ";
+    if (dropsBefore < 0 || dropsAfter < 0)
+    {
+        std::cout << "n/a";
+    }
+    else
+    {
+        std::cout << (dropsAfter - dropsBefore);
+    }
+    std::cout << std::endl;
+    return 0;
+}
@@ -0,0 +1,110 @@
+// Memory per slot of a large zone, outside the server, measured as heap
+// growth (glibc mallinfo2):
+//   model     the zone's areas (PackedSlot words, id side tables)
+//   indexes   the areas' free-slot trees
+//   snapshot  the zone's first published ZoneSnapshot and its SlotLayout
+// for a zone of uniform areas and one whose areas mix two slot types.
+// Also times single-slot requestParking calls against the big zone, i.e.
+// the cost of one snapshot update.
+//
+// usage: slot_memory [--slots 1000000] [--area 1000] [--writes 2000]
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <malloc.h>
+#include <string>
+#include <utility>
+
+#include "../ParkingSystem.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+    long long heapInUse()
+    {
+        struct mallinfo2 info = mallinfo2();
+        return static_cast<long long>(info.uordblks + info.hblkhd);
+    }
+
+    void report(const char* what, long long bytes, int slots)
+    {
+        std::cout << "  " << std::left << std::setw(10) << what << std::right
+                  << std::fixed << std::setprecision(2) << std::setw(8)
+                  << static_cast<double>(bytes) / slots << " B/slot\n";
+    }
+
+    // Every tenth slot of a mixed area is an EV bay.
+    Zone buildZone(int zoneId, int slots, int areaSize, bool mixed)
+    {
+        Zone zone(zoneId);
+        zone.reserveAreas(static_cast<std::size_t>(slots / areaSize));
+        int nextId = 1;
+        for (int areaId = 0; areaId < slots / areaSize; ++areaId)
+        {
+            if (!mixed)
+            {
+                zone.addArea(areaId, areaSize);
+                continue;
+            }
+
+            ParkingArea area(areaId);
+            for (int i = 0; i < areaSize; ++i)
+            {
+                ParkingSlot slot(nextId++, zoneId);
+                slot.setType(static_cast<int>(i % 10 == 9 ? ParkingSlot::Type::EV : ParkingSlot::Type::STANDARD));
+                area.addParkingSlot(slot);
+            }
+            zone.addParkingArea(std::move(area));
+        }
+        return zone;
+    }
+
+    void run(const char* name, int slots, int areaSize, int writes, bool mixed)
+    {
+        std::cout << name << " (" << slots << " slots, areas of " << areaSize << ")\n";
+
+        ParkingSystem system;
+
+        long long before = heapInUse();
+        Zone zone = buildZone(7, slots, areaSize, mixed);
+        long long model = heapInUse();
+        zone.refreshIndexes();
+        long long indexed = heapInUse();
+        system.emplaceZone(std::move(zone));
+        long long published = heapInUse();
+
+        report("model", model - before, slots);
+        report("indexes", indexed - model, slots);
+        report("snapshot", published - indexed, slots);
+        report("total", published - before, slots);
+
+        auto start = Clock::now();
+        for (int i = 0; i < writes; ++i)
+        {
+            system.requestParking("V" + std::to_string(i), 7);
+        }
+        double micros = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / writes;
+        std::cout << "  requestParking " << std::setprecision(1) << micros << " us each\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int slots = 1000000;
+    int areaSize = 1000;
+    int writes = 2000;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (std::strcmp(argv[i], "--slots") == 0) slots = std::atoi(argv[i + 1]);
+        if (std::strcmp(argv[i], "--area") == 0) areaSize = std::atoi(argv[i + 1]);
+        if (std::strcmp(argv[i], "--writes") == 0) writes = std::atoi(argv[i + 1]);
+    }
+
+    run("uniform areas", slots, areaSize, writes, false);
+    run("mixed areas", slots, areaSize, writes, true);
+    return 0;
+}
@@ -11,20 +11,43 @@ if ! command -v g++ &> /dev/null; then
 fi
 
 echo "Compiling Server.cpp with all dependencies..."
-g++ -std=c++17 \
+g++ -std=c++20 -DCROW_ENABLE_COMPRESSION \
     Server.cpp \
+    Awaitables.cpp \
+    FacilityTree.cpp \
+    PriceCurve.cpp \
     ParkingSystem.cpp \
+    ParkingSnapshot.cpp \
+    CommandQueue.cpp \
+    GateServer.cpp \
+    RequestIndex.cpp \
+    ReadWriteLock.cpp \
+    SlotWaiters.cpp \
+    UsageHistory.cpp \
+    RequestStats.cpp \
+    TDigest.cpp \
+    OccupancyArchive.cpp \
     Zone.cpp \
     ParkingArea.cpp \
+    FreeRunTree.cpp \
     ParkingSlot.cpp \
     ParkingRequest.cpp \
     Vehicle.cpp \
     AllocateEngine.cpp \
     RollBackManager.cpp \
+    JsonWriter.cpp \
+    FreeCountBoard.cpp \
+    HttpCompression.cpp \
+    OccupancyFeed.cpp \
+    ResponseCache.cpp \
+    SensorListener.cpp \
+    SnapshotJson.cpp \
+    StreamServer.cpp \
     -Iserver/Crow-master/include \
     -Iserver/asio-master/include \
     -o smart_parking_server \
-    -pthread
+    -pthread \
+    -lz
 
 if [ $? -eq 0 ]; then
     echo
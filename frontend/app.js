@@ -2,6 +2,7 @@
 // Connects UI with backend APIs using fetch
 
 const API_BASE = 'http://localhost:8080/api';
+const OCCUPANCY_WS = 'ws://localhost:8080/ws/occupancy';
 
 // Application State
 const appState = {
@@ -10,7 +11,9 @@ const appState = {
     activePage: 'dashboard',
     isLiveMode: false,
     lastRequestId: null,
-    charts: {}
+    charts: {},
+    // Live occupancy mirror maintained from the WebSocket feed
+    live: null
 };
 
 // Debug logging helper
@@ -328,6 +331,75 @@ function refreshDashboard() {
     loadDashboard();
 }
 
+// ==================== Live Occupancy Feed ====================
+
+/**
+ * Subscribe to server-pushed occupancy (full snapshot once, then deltas).
+ * Keeps appState.live current without polling the REST endpoints.
+ */
+function connectOccupancyFeed() {
+    let socket;
+    try {
+        socket = new WebSocket(OCCUPANCY_WS);
+    } catch (error) {
+        return;
+    }
+
+    socket.onmessage = (event) => {
+        const msg = JSON.parse(event.data);
+        if (msg.type === 'snapshot') {
+            appState.live = { zones: new Map() };
+            msg.zones.forEach(zone => appState.live.zones.set(zone.id, zone));
+        } else if (msg.type === 'delta' && appState.live) {
+            msg.added.forEach(zone => appState.live.zones.set(zone.id, zone));
+            msg.zones.forEach(update => {
+                const zone = appState.live.zones.get(update.id);
+                if (zone) {
+                    zone.capacity = update.capacity;
+                    zone.occupiedSlots = update.occupiedSlots;
+                }
+            });
+            msg.slots.forEach(([zoneId, index, occupied]) => {
+                const zone = appState.live.zones.get(zoneId);
+                if (zone) {
+                    zone.occupancy = zone.occupancy.substring(0, index) + (occupied ? '1' : '0') + zone.occupancy.substring(index + 1);
+                }
+            });
+        } else {
+            return;
+        }
+
+        appState.live.totalSlots = msg.totalSlots;
+        appState.live.occupiedSlots = msg.occupiedSlots;
+        appState.live.activeRequests = msg.activeRequests;
+        renderLiveDashboard();
+    };
+
+    // Reconnect after a short pause; the server resends a full snapshot.
+    socket.onclose = () => {
+        appState.live = null;
+        setTimeout(connectOccupancyFeed, 3000);
+    };
+}
+
+/**
+ * Update dashboard stats and zone cards from the live feed (no fetches)
+ */
+function renderLiveDashboard() {
+    const live = appState.live;
+    if (!live || appState.activePage !== 'dashboard') return;
+
+    const zones = Array.from(live.zones.values());
+    const utilization = live.totalSlots > 0 ? Math.round((live.occupiedSlots / live.totalSlots) * 100) : 0;
+
+    document.getElementById('total-zones').textContent = zones.length;
+    document.getElementById('occupied-slots').textContent = `${live.occupiedSlots}/${live.totalSlots}`;
+    document.getElementById('active-requests').textContent = live.activeRequests;
+    document.getElementById('utilization').textContent = `${utilization}%`;
+
+    renderZonesOverview(zones);
+}
+
 /**
  * View zone detail (called from zone card onclick)
  */
@@ -914,6 +986,9 @@ async function init() {
         timeRange.addEventListener('change', () => loadAnalytics());
     }
 
+    // Live dashboard updates pushed by the server
+    connectOccupancyFeed();
+
     // Load initial page
     switchPage('dashboard');
     __debugLog('H5', 'frontend/app.js:init', 'init.end', { activePage: 'dashboard' });
@@ -256,7 +256,15 @@ namespace crow
                 }
                 if (complete_request_handler_)
                 {
-                    complete_request_handler_();
+                    // LOCAL PATCH (see server/README.md, "Vendored Crow
+                    // patches"): Connection::complete_request() clears
+                    // complete_request_handler_ while it is running. When
+                    // end() is called after the route handler returned, that
+                    // handler holds the last reference to the connection, so
+                    // the connection and this response were destroyed inside
+                    // their own callback (double free). Move it out first.
+                    auto complete = std::move(complete_request_handler_);
+                    complete();
                     manual_length_header = false;
                     skip_body = false;
                 }
@@ -0,0 +1,182 @@
+// Slot-type rules of requestParking, outside the server: an untyped
+// request is a standard car, so it may take STANDARD and then OVERSIZED
+// bays but never EV or ACCESSIBLE ones, and a run of adjacent slots never
+// mixes types. Also that a zone id can only be added once, and that slot
+// waiters only count and wake on bays a standard car may use.
+//
+// usage: allocation_test   (exits non-zero on the first failure)
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include "../ParkingSystem.h"
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool ok, const char* what)
+    {
+        std::cout << (ok ? "  ok    " : "  FAIL  ") << what << "\n";
+        if (!ok)
+        {
+            failures += 1;
+        }
+    }
+
+    int typeOf(const ParkingSystem& system, int requestId)
+    {
+        return system.getSnapshot()->getRequest(requestId).slotType;
+    }
+
+    int slotOf(const ParkingSystem& system, int requestId)
+    {
+        return system.getSnapshot()->getRequest(requestId).allocatedSlotId;
+    }
+
+    const int STANDARD = static_cast<int>(ParkingSlot::Type::STANDARD);
+    const int EV = static_cast<int>(ParkingSlot::Type::EV);
+    const int ACCESSIBLE = static_cast<int>(ParkingSlot::Type::ACCESSIBLE);
+    const int OVERSIZED = static_cast<int>(ParkingSlot::Type::OVERSIZED);
+
+    void fullStandardAreaDoesNotSpill()
+    {
+        std::cout << "full standard area\n";
+
+        ParkingSystem system;
+        Zone zone(1);
+        zone.addArea(0, 2, STANDARD);
+        zone.addArea(1, 2, EV);
+        zone.addArea(2, 1, ACCESSIBLE);
+        system.emplaceZone(std::move(zone));
+
+        int first = system.requestParking("A", 1);
+        int second = system.requestParking("B", 1);
+        check(first >= 0 && typeOf(system, first) == STANDARD, "first untyped request gets a standard bay");
+        check(second >= 0 && typeOf(system, second) == STANDARD, "second untyped request gets a standard bay");
+        check(system.requestParking("C", 1) == -1, "third untyped request fails instead of taking an EV bay");
+        check(system.requestParking("D", 1, 2) == -1, "untyped run fails instead of taking the EV bays");
+
+        int ev = system.requestParking("E", 1, 1, EV);
+        check(ev >= 0 && typeOf(system, ev) == EV, "EV request still gets an EV bay");
+        int pair = system.requestParking("F", 1, 2, EV);
+        check(pair == -1, "EV run of two fails with one EV bay left");
+    }
+
+    void untypedFallsBackToOversized()
+    {
+        std::cout << "oversized fallback\n";
+
+        ParkingSystem system;
+        Zone zone(1);
+        zone.addArea(0, 1, EV);
+        zone.addArea(1, 1, OVERSIZED);
+        system.emplaceZone(std::move(zone));
+
+        int id = system.requestParking("A", 1);
+        check(id >= 0 && typeOf(system, id) == OVERSIZED, "untyped request takes the oversized bay, not the EV bay");
+        check(system.requestParking("B", 1) == -1, "next untyped request fails");
+    }
+
+    void runDoesNotSpanTypes()
+    {
+        std::cout << "mixed area\n";
+
+        // Slots 1-5: STANDARD STANDARD EV STANDARD STANDARD
+        ParkingSystem system;
+        Zone zone(1);
+        ParkingArea area(0);
+        for (int id = 1; id <= 5; ++id)
+        {
+            ParkingSlot slot(id, 1);
+            slot.setType(id == 3 ? EV : STANDARD);
+            area.addParkingSlot(slot);
+        }
+        zone.addParkingArea(std::move(area));
+        system.emplaceZone(std::move(zone));
+
+        check(system.requestParking("A", 1, 3) == -1, "run of three does not span the EV bay");
+
+        int pair = system.requestParking("B", 1, 2);
+        check(pair >= 0 && slotOf(system, pair) == 1, "run of two takes slots 1-2");
+        pair = system.requestParking("C", 1, 2);
+        check(pair >= 0 && slotOf(system, pair) == 4, "next run of two skips the EV bay and takes slots 4-5");
+        check(system.requestParking("D", 1) == -1, "single untyped request fails with only the EV bay free");
+    }
+
+    void compactRunUsesStandardBays()
+    {
+        std::cout << "typed runs\n";
+
+        ParkingSystem system;
+        Zone zone(1);
+        zone.addArea(0, 1, static_cast<int>(ParkingSlot::Type::COMPACT));
+        zone.addArea(1, 2, STANDARD);
+        system.emplaceZone(std::move(zone));
+
+        int id = system.requestParking("A", 1, 2, static_cast<int>(ParkingSlot::Type::COMPACT));
+        check(id >= 0 && typeOf(system, id) == STANDARD, "compact run of two falls back to standard bays");
+    }
+
+    void duplicateZoneIsRejected()
+    {
+        std::cout << "duplicate zone\n";
+
+        ParkingSystem system;
+        Zone first(1);
+        first.addArea(0, 1, STANDARD);
+        Zone second(1);
+        second.addArea(0, 4, STANDARD);
+        check(system.emplaceZone(std::move(first)), "first zone 1 is added");
+        check(!system.emplaceZone(std::move(second)), "second zone 1 is rejected");
+        check(system.getSnapshot()->totalSlots == 1, "the rejected zone's slots are not counted");
+
+        int id = system.requestParking("A", 1);
+        check(id >= 0 && system.getSnapshot()->findZone(1)->occupiedSlots == 1, "allocation lands in the zone the snapshot shows");
+        check(system.requestParking("B", 1) == -1, "no slot of the rejected zone is handed out");
+    }
+
+    void waiterIgnoresEvBays()
+    {
+        std::cout << "slot waiters\n";
+
+        ParkingSystem system;
+        Zone zone(1);
+        zone.addArea(0, 1, STANDARD);
+        zone.addArea(1, 1, EV);
+        system.emplaceZone(std::move(zone));
+
+        int car = system.requestParking("A", 1);
+        int ev = system.requestParking("B", 1, 1, EV);
+        check(system.getSnapshot()->findZone(1)->freeStandard == 0, "no standard bay is free");
+
+        int wakes = 0;
+        std::uint64_t token = system.waitForSlot(1, [&wakes]() { wakes += 1; });
+        check(token != 0, "waiter registers while only standard bays are full");
+
+        system.cancelRequest(ev);
+        check(wakes == 0, "freeing the EV bay does not wake the waiter");
+        check(system.waitForSlot(1, []() {}) != 0, "a free EV bay does not satisfy a new waiter");
+
+        system.cancelRequest(car);
+        check(wakes == 1, "freeing the standard bay wakes the oldest waiter");
+        check(system.getSnapshot()->findZone(1)->freeStandard == 1, "freeStandard counts the freed bay");
+        check(system.waitForSlot(1, []() {}) == 0, "a free standard bay satisfies a waiter at once");
+    }
+}
+
+int main()
+{
+    fullStandardAreaDoesNotSpill();
+    untypedFallsBackToOversized();
+    runDoesNotSpanTypes();
+    compactRunUsesStandardBays();
+    duplicateZoneIsRejected();
+    waiterIgnoresEvBays();
+
+    std::cout << (failures == 0 ? "all passed\n" : "FAILED\n");
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,19 @@
+#!/bin/bash
+# Builds and runs the allocation and t-digest checks outside the server.
+# Run from the repository root.
+#
+#   tests/run_tests.sh
+
+g++ -std=c++20 -O2 tests/allocation_test.cpp \
+    ParkingSystem.cpp ParkingSnapshot.cpp AllocateEngine.cpp Zone.cpp ParkingArea.cpp \
+    FreeRunTree.cpp ParkingSlot.cpp ParkingRequest.cpp Vehicle.cpp FacilityTree.cpp \
+    PriceCurve.cpp RequestIndex.cpp RequestStats.cpp TDigest.cpp SlotWaiters.cpp \
+    UsageHistory.cpp ReadWriteLock.cpp \
+    -o tests/allocation_test \
+    -pthread || exit 1
+
+g++ -std=c++20 -O2 tests/tdigest_test.cpp TDigest.cpp \
+    -o tests/tdigest_test || exit 1
+
+tests/allocation_test || exit 1
+tests/tdigest_test
@@ -0,0 +1,67 @@
+// TDigest::merge keeps the exact extremes of both sides: a merged digest
+// of tens of thousands of values (enough that the outer centroids hold
+// several each) reports their true min / max, and p0 / p100 interpolate
+// to them.
+//
+// usage: tdigest_test   (exits non-zero on the first failure)
+
+#include <cstdlib>
+#include <iostream>
+
+#include "../TDigest.h"
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool ok, const char* what)
+    {
+        std::cout << (ok ? "  ok    " : "  FAIL  ") << what << "\n";
+        if (!ok)
+        {
+            failures += 1;
+        }
+    }
+
+    // count values from first, step apart, in a shuffled-looking order so
+    // the extremes land in the middle of the buffer.
+    void fill(TDigest& digest, double first, double step, int count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            int k = static_cast<int>((static_cast<long long>(i) * 7919) % count);
+            digest.add(first + step * k);
+        }
+    }
+}
+
+int main()
+{
+    std::cout << "merged extremes\n";
+
+    TDigest low;
+    TDigest high;
+    fill(low, 10, 1, 20000);     // 10 .. 20009
+    fill(high, 30000, 2, 30000); // 30000 .. 89998
+
+    TDigest merged;
+    merged.merge(low);
+    merged.merge(high);
+    merged.merge(TDigest());
+
+    check(merged.getCount() == 50000, "count is the sum of both sides");
+    check(merged.getMin() == 10, "min is the smallest value added");
+    check(merged.getMax() == 89998, "max is the largest value added");
+    check(merged.quantile(0) == 10, "p0 is the exact min");
+    check(merged.quantile(1) == 89998, "p100 is the exact max");
+
+    std::cout << "merge into a non-empty digest\n";
+
+    TDigest into;
+    into.add(100000);
+    into.merge(low);
+    check(into.getMin() == 10 && into.getMax() == 100000, "keeps its own max and takes other's min");
+
+    std::cout << (failures == 0 ? "all passed\n" : "FAILED\n");
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}